@@ -0,0 +1,45 @@
+//////////////////////////////////////////////////////////////////////////
+//	py.js - Node.js/Python Bridge; Node.js-hosted Python.
+//	Copyright (C) 2019  Michael Brown
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as
+//	published by the Free Software Foundation, either version 3 of the
+//	License, or (at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//	Additional permission under the GNU Affero GPL version 3 section 7:
+//
+//	If you modify this Program, or any covered work, by linking or
+//	combining it with other code, such other code is not for that reason
+//	alone subject to any of the requirements of the GNU Affero GPL
+//	version 3.
+//////////////////////////////////////////////////////////////////////////
+
+'use strict'
+
+//Compares native BigInt <-> int marshalling against the decimal string
+//round-trip that was previously used (str() in Python, BigInt() in JS).
+
+module.exports = (p, measure) => {
+	let b = p.import('01_bigint')
+	let values = {
+		'small (42n)': 42n,
+		'int64 (-(2n**62n))': -(2n**62n),
+		'wide (2n**512n + 1n)': 2n**512n + 1n
+	}
+
+	for (let [name, n] of Object.entries(values))
+	{
+		let str = n.toString()
+		measure(`native echo ${name}`, 20000, () => b.echo(n))
+		measure(`string echo ${name}`, 20000, () => BigInt(b.echo_str(str)))
+	}
+}
@@ -0,0 +1,58 @@
+//////////////////////////////////////////////////////////////////////////
+//	py.js - Node.js/Python Bridge; Node.js-hosted Python.
+//	Copyright (C) 2019  Michael Brown
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as
+//	published by the Free Software Foundation, either version 3 of the
+//	License, or (at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//	Additional permission under the GNU Affero GPL version 3 section 7:
+//
+//	If you modify this Program, or any covered work, by linking or
+//	combining it with other code, such other code is not for that reason
+//	alone subject to any of the requirements of the GNU Affero GPL
+//	version 3.
+//////////////////////////////////////////////////////////////////////////
+
+'use strict'
+
+//Baseline for the batched element wrapping: one boundary crossing and proxy per element, as
+//when each element went through its own _JS_Wrap call. Emulated with __getitem__ on a reference.
+const per_element = (fn, n) => {
+	let get = fn.$newMode({getReference: true})(n).__getitem__
+	let res = new Array(n)
+	for (let i = 0; i < n; i++)
+		res[i] = get(i)
+	return res
+}
+
+module.exports = (p, measure) => {
+	let s = p.import('02_sequence')
+	let floats = s.floats.$newMode({numericArrays: true})
+	let ints = s.ints.$newMode({numericArrays: true})
+
+	for (let n of [10000, 1000000])
+	{
+		let iterations = n > 10000 ? 10 : 200
+		measure(`float list (${n}) as Array`, iterations, () => s.floats(n))
+		measure(`float list (${n}) as Float64Array`, iterations, () => floats(n))
+		measure(`int list (${n}) as Array`, iterations, () => s.ints(n))
+		measure(`int list (${n}) as Int32Array`, iterations, () => ints(n))
+	}
+
+	//Per-element overhead of the regular Array path.
+	measure('str list (100000)', 20, () => s.strs(100000))
+	measure('object list (100000)', 20, () => s.objects(100000))
+	measure('object list (100000) per element', 20, () => per_element(s.objects, 100000))
+	measure('mixed list (100000)', 20, () => s.mixed(100000))
+	measure('mixed list (100000) per element', 20, () => per_element(s.mixed, 100000))
+}
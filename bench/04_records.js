@@ -0,0 +1,49 @@
+//////////////////////////////////////////////////////////////////////////
+//	py.js - Node.js/Python Bridge; Node.js-hosted Python.
+//	Copyright (C) 2019  Michael Brown
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as
+//	published by the Free Software Foundation, either version 3 of the
+//	License, or (at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//	Additional permission under the GNU Affero GPL version 3 section 7:
+//
+//	If you modify this Program, or any covered work, by linking or
+//	combining it with other code, such other code is not for that reason
+//	alone subject to any of the requirements of the GNU Affero GPL
+//	version 3.
+//////////////////////////////////////////////////////////////////////////
+
+'use strict'
+
+const FIELDS = ['id', 'name', 'email', 'created', 'score', 'active', 'region', 'plan',
+	'seats', 'owner', 'status', 'tags', 'updated', 'source', 'notes']
+
+const record = (i) => {
+	let r = {}
+	FIELDS.forEach((f, j) => r[f] = j % 3 == 0 ? i + j : `${f}_${i}`)
+	return r
+}
+
+module.exports = (p, measure) => {
+	let c = p.import('04_records')
+	let columns = c.count.$newMode({ recordsAsColumns: true })
+
+	for (let n of [100, 10000])
+	{
+		let records = Array.from({ length: n }, (_, i) => record(i))
+		let iterations = n > 100 ? 20 : 1000
+		measure(`js records -> list[dict] (${n})`, iterations, () => c.count(records))
+		measure(`js records -> dict[list] (${n})`, iterations, () => columns(records))
+		measure(`kwargs call (${FIELDS.length} names)`, iterations, () => c.kwargs(records[0]))
+	}
+}
@@ -0,0 +1,51 @@
+//////////////////////////////////////////////////////////////////////////
+//	py.js - Node.js/Python Bridge; Node.js-hosted Python.
+//	Copyright (C) 2019  Michael Brown
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as
+//	published by the Free Software Foundation, either version 3 of the
+//	License, or (at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//	Additional permission under the GNU Affero GPL version 3 section 7:
+//
+//	If you modify this Program, or any covered work, by linking or
+//	combining it with other code, such other code is not for that reason
+//	alone subject to any of the requirements of the GNU Affero GPL
+//	version 3.
+//////////////////////////////////////////////////////////////////////////
+
+'use strict'
+
+module.exports = (p, measure) => {
+	let c = p.import('05_calls')
+	let iterations = 100000
+
+	measure('score() no arguments', iterations, () => c.noop())
+	measure('score(x, y) positional', iterations, () => c.score(1.5, 2.5))
+	measure('score(x, y, bias=) keywords', iterations, () => c.score.$apply([1.5, 2.5], { bias: 0.5 }))
+
+	let scorer = c.Scorer(0.5)
+	measure('scorer.score(x, y) method', iterations, () => scorer.score(1.5, 2.5))
+
+	let chained = p.plan('c', 'x', 'y')`c.Scorer(0.5).score(x, y)`
+	measure('c.Scorer(bias).score(x, y) chained', iterations, () => c.Scorer(0.5).score(1.5, 2.5))
+	measure('c.Scorer(bias).score(x, y) plan', iterations, () => chained(c, 1.5, 2.5))
+
+	let sets = [...Array(1000).keys()].map((i) => [i * 0.5, i * 0.25])
+	measure('score(x, y) for-loop x1000', iterations / 1000, () => {
+		let res = new Array(sets.length)
+		for (let i = 0; i < sets.length; i++)
+			res[i] = c.score(...sets[i])
+		return res
+	})
+	measure('score.$map(sets) x1000', iterations / 1000, () => c.score.$map(sets))
+}
@@ -0,0 +1,40 @@
+#//////////////////////////////////////////////////////////////////////////
+#//	py.js - Node.js/Python Bridge; Node.js-hosted Python.
+#//	Copyright (C) 2019  Michael Brown
+#//
+#//	This program is free software: you can redistribute it and/or modify
+#//	it under the terms of the GNU Affero General Public License as
+#//	published by the Free Software Foundation, either version 3 of the
+#//	License, or (at your option) any later version.
+#//
+#//	This program is distributed in the hope that it will be useful,
+#//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+#//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#//	GNU Affero General Public License for more details.
+#//
+#//	You should have received a copy of the GNU Affero General Public License
+#//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#//
+#//	Additional permission under the GNU Affero GPL version 3 section 7:
+#//
+#//	If you modify this Program, or any covered work, by linking or
+#//	combining it with other code, such other code is not for that reason
+#//	alone subject to any of the requirements of the GNU Affero GPL
+#//	version 3.
+#//////////////////////////////////////////////////////////////////////////
+
+_cache = {}
+
+def _cached(key, n, fn):
+	if (key, n) not in _cache:
+		_cache[(key, n)] = fn(n)
+	return _cache[(key, n)]
+
+def dict(n):
+	return _cached('dict', n, lambda n: {'key_%d' % i: i for i in range(n)})
+
+def object_dict(n):
+	return _cached('object_dict', n, lambda n: {'key_%d' % i: object() for i in range(n)})
+
+def int_set(n):
+	return _cached('int_set', n, lambda n: set(range(n)))
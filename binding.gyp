@@ -3,13 +3,15 @@
         "target_name": "pyjs",
         "cflags!": [ "-fno-exceptions" ],
         "cflags_cc!": [ "-fno-exceptions" ],
+        "defines": [ "NAPI_VERSION=8" ],
         "sources": [
             "src/pyjs.cpp",
             "src/pyjs_pyobj.cpp",
 			"src/pyjs_async.cpp",
             "src/pyjs_utils.cpp",
 			"src/pyjs_common.cpp",
-			"src/pyjs_contrib.cpp"
+			"src/pyjs_contrib.cpp",
+			"src/pyjs_buffer.cpp"
         ],
         "conditions": [
             ['OS=="linux" or OS=="freebsd" or OS=="openbsd" or OS=="solaris"', {
@@ -26,7 +26,6 @@
 
 const fs = require('fs')
 const path = require('path')
-const util = require('util')
 
 const chalk = require('chalk')
 const moment = require('moment')
@@ -50,20 +49,6 @@ const _debug_handler = function() {
 	console.log(chalk`[{blue ${ticks}}{gray #}{green ${thread_id}}] {yellow ${debug_data[0]}}`)
 }
 
-////////////////////////////////////////////
-// Special Type Checker
-////////////////////////////////////////////
-
-const _js_type_checking_types = {
-	UNKNOWN_JS_TYPE: 0,
-	JS_DATETIME: 1
-}
-
-const _js_type_checking = (obj) => {
-	if (util.isDate(obj))
-		return _js_type_checking_types.JS_DATETIME
-}
-
 ////////////////////////////////////////////
 // Setup
 ////////////////////////////////////////////
@@ -71,9 +56,6 @@ const _js_type_checking = (obj) => {
 _etc.set_pyjs(_pyjs)
 _pyjs.$SetDebugMessagingCallback(_debug_handler)
 _pyjs.$SetSerializationCallbackConstructor(_etc.default_serializer)
-_pyjs.$SetSerializationFilterConstructor(_etc.serializaition_filter)
-_pyjs.$SetUnmarshallingFilter(_etc.unmarshalling_filter)
-_pyjs.$SetJSTypeCheckingCallback(_js_type_checking)
 
 ////////////////////////////////////////////
 // Pass-through Functions
@@ -92,7 +74,9 @@ let fns = {
 		_etc.marshalling_factory(
 			_pyjs.global()).__builtins__,
 	$GetCurrentThreadID: () =>
-		_pyjs.$GetCurrentThreadID()
+		_pyjs.$GetCurrentThreadID(),
+	stats: () =>
+		_pyjs.$GetStats()
 }
 for (let f in fns)
 	pyjs[f] = _apply(fns[f])
@@ -109,10 +93,24 @@ pyjs.import = function () {
 		_pyjs.import.apply(this, arguments))
 }
 
-pyjs.eval = function (code, {tag} = {}) {
+let _check_bindings = (bindings, namespace) => {
+	if (!_etc.parameter_check.methods.undefined.f(bindings)
+		&& !_etc.parameter_check.methods.object.f(bindings)) {
+		throw Error("Option 'bindings' must be an object.")
+	}
+	if (!_etc.parameter_check.methods.undefined.f(namespace)
+		&& (!_etc.parameter_check.methods.function.f(namespace)
+			|| _etc.get_raw_object(namespace) === undefined)) {
+		throw Error("Option 'namespace' must be created by pyjs.namespace().")
+	}
+}
+
+//bindings: JS values converted straight into Python variables, rather than spliced into code.
+//namespace: from pyjs.namespace(); code runs inside it, and anything it defines persists there.
+pyjs.eval = function (code, {tag, bindings, namespace} = {}) {
 	_etc.parameter_check('eval', [
 		_etc.parameter_check.methods.string ],
-		arguments)
+		[code])
 
 	code += '\n'
 	let s_tag = '=node.js'
@@ -122,21 +120,61 @@ pyjs.eval = function (code, {tag} = {}) {
 	else if (!_etc.parameter_check.methods.undefined.f(tag)) {
 		throw Error("Option 'tag' must be a string.")
 	}
+	_check_bindings(bindings, namespace)
 	
 	return _etc.marshalling_factory(
-		_pyjs.eval(code, s_tag))
+		_pyjs.eval(code, s_tag, bindings, namespace))
 }
 
-pyjs.evalAsFile = function (code, path) {
+pyjs.evalAsFile = function (code, path, {bindings, namespace} = {}) {
 	_etc.parameter_check('evalAsFile', [
 		_etc.parameter_check.methods.string,
 		_etc.parameter_check.methods.string ],
-		arguments)
+		[code, path])
 
 	code += '\n'
-	_pyjs.evalAsFile(code, path)
+	_check_bindings(bindings, namespace)
+	_pyjs.evalAsFile(code, path, bindings, namespace)
 }
 
+//A Python dict that eval, evalAsFile and compiled code can run in, keeping state between runs.
+pyjs.namespace = function (initial = {}) {
+	if (!_etc.parameter_check.methods.object.f(initial)) {
+		throw Error("Initial namespace contents must be an object.")
+	}
+	return _etc.marshalling_factory(
+		_pyjs.$GetMarshaledObject(initial))
+}
+
+//Compiles once (through the shared code cache) and returns a function of the variables to bind.
+pyjs.compile = function (code, {tag, mode = 'eval'} = {}) {
+	_etc.parameter_check('compile', [
+		_etc.parameter_check.methods.string ],
+		[code])
+	code += '\n'
+	let s_tag = '=node.js'
+	if (_etc.parameter_check.methods.string.f(tag)) {
+		s_tag = tag
+	}
+	else if (!_etc.parameter_check.methods.undefined.f(tag)) {
+		throw Error("Option 'tag' must be a string.")
+	}
+	if (mode !== 'eval' && mode !== 'exec') {
+		throw Error("Option 'mode' must be 'eval' or 'exec'.")
+	}
+
+	let compiled = _pyjs.$Compile(code, s_tag, mode === 'exec')
+	return (bindings = {}, {namespace} = {}) => {
+		_check_bindings(bindings, namespace)
+		return _etc.marshalling_factory(
+			_pyjs.$EvalCode(compiled, bindings, namespace))
+	}
+}
+
+//plan`expr` or plan('a', 'b')`expr`; evaluates a chain of attribute/item access, calls and
+//list/tuple literals natively.
+pyjs.plan = require('./js/plan.js')(_pyjs, _etc)
+
 //Shortcuts
 //pyjs.e = 
 
@@ -144,6 +182,7 @@ pyjs.evalAsFile = function (code, path) {
 // Helpers (pyjs_common.cpp)
 ////////////////////////////////////////////
 
+let _from_columns = undefined
 pyjs.$coerceAs = {
 	Integer: function(num) {
 		if (_etc.parameter_check.methods.number.f(num)) {
@@ -165,6 +204,37 @@ pyjs.$coerceAs = {
 		return _etc.marshalling_factory(
 			_pyjs.$coerceAs.Tuple(
 				array.map(x => _pyjs.$GetMarshaledObject(x))))
+	},
+	View: function(typed_array) {
+		if (!ArrayBuffer.isView(typed_array) || typed_array instanceof DataView) {
+			throw Error("You must supply a TypedArray to coerce as view.")
+		}
+
+		return _etc.marshalling_factory(
+			_pyjs.$coerceAs.View(typed_array))
+	},
+	NDArray: function(typed_array) {
+		//numpy.asarray shares the view's memory, so the ndarray aliases the TypedArray.
+		return pyjs.import('numpy').asarray
+			.$newMode({getReference: true})(pyjs.$coerceAs.View(typed_array))
+	},
+	Columns: function(records) {
+		if (!_etc.parameter_check.methods.array.f(records)) {
+			throw Error("You must supply an array to coerce as columns.")
+		}
+
+		//Rows that don't share the first row's keys come back as a plain list.
+		return _etc.marshalling_factory(
+			_pyjs.$GetMarshaledObject(records, { recordsAsColumns: true }))
+	},
+	StructuredArray: function(records) {
+		if (_from_columns === undefined) {
+			_from_columns = pyjs.eval(
+				'lambda c: __import__("numpy").rec.fromarrays(list(c.values()), names=list(c))')
+				.$newMode({getReference: true})
+		}
+
+		return _from_columns(pyjs.$coerceAs.Columns(records))
 	}
 }
 
@@ -75,13 +75,9 @@ _etc.python_object_type = _etc.python_object_type()
 _etc.default_serializer = (type, obj, ...etc) => _local.serializers[type](type, obj, etc)
 
 _local.serializers = {
-	[_etc.python_object_type.INTEGER]: (type, obj) => BigInt(obj),
 	[_etc.python_object_type.COMPLEX]: (type, obj) => new _etc.python_types.Complex(obj[0], obj[1]),
 	//[_etc.python_object_type.TUPLE]: (type, obj) => new _etc.python_types.Tuple(obj),
-	[_etc.python_object_type.DICTIONARY]: (type, obj, etc) => _etc.python_types.Dictionary(obj, etc),
-	[_etc.python_object_type.SET]: (type, obj) => _etc.python_types.Set(obj),
 	[_etc.python_object_type.PYTHON_EXCEPTION]: (type, obj) => _etc.python_types.Exception(obj),
-	[_etc.python_object_type._JS_DATETIME]: (type, obj) => _etc.python_types._js_datetime(obj),
 	[_etc.python_object_type._JS_FUNCTION]: (type, obj) => _etc.python_types._js_function(obj),
 	[_etc.python_object_type._JS_WRAP]: (type, obj) => _etc.python_types._js_wrap(obj)
 }
@@ -180,19 +176,6 @@ _etc.python_types = {
 			return `${tag}( ${items} )`
 		}
 	},*/
-	Dictionary: (obj, vals) => {
-		if (obj === null) {
-			return new Map()
-		}
-
-		obj.set(
-			_etc.marshalling_factory(vals[0]), 
-			_etc.marshalling_factory(vals[1])
-		)
-	},
-	Set: (obj) => {
-		return new Set(obj)
-	},
 	Exception: (obj) => {
 		let ex = _local._pyjs.pyjs
 			.exceptions().PythonException
@@ -200,11 +183,6 @@ _etc.python_types = {
 			_etc.marshalling_factory(obj.exception))
 		return ret
 	},
-	_js_datetime: (obj) => {
-		let datetime = _local._pyjs.pyjs.import('datetime').datetime
-		let dt = datetime.fromtimestamp(obj.getTime() / 1000)
-		return dt[_local.marshaled_object_tag]
-	},
 	_js_function: (ptr) => {
 		//get a normal (non-async) version of the callback_factory
 		//we can't invoke otherwise (we'd get undefined back in FunctionCallAsync)
@@ -212,8 +190,11 @@ _etc.python_types = {
 		let wrapper = wrapped[_local.marshaled_object_tag]
 		return wrapper
 	},
-	_js_wrap: (obj) => {
-		return _etc.marshalling_factory(obj)
+	_js_wrap: (objs) => {
+		//Batched per container; native code only sends NapiPyObject instances.
+		for (let i = 0; i < objs.length; i++)
+			objs[i] = _etc.marshalling_factory(objs[i])
+		return objs
 	}
 }
 
@@ -258,10 +239,12 @@ _local.object_attributes = {
 		$length: '__len__'
 	},
 	callable: {
-		$apply: (t) => t.$apply
+		$apply: (t) => t.$apply,
+		$map: (t) => t.$map
 	},
 	class: {
-		$apply: (t) => t.$apply
+		$apply: (t) => t.$apply,
+		$map: (t) => t.$map
 	}
 }
 
@@ -269,35 +252,9 @@ _local.marshaled_object_tag = Symbol('marshaled obj')
 _etc.get_raw_object = (obj) => {
 	return obj[_local.marshaled_object_tag]
 }
-_etc.unmarshalling_filter = (obj) => {
-	let lmo = obj[_local.marshaled_object_tag]
-	if (lmo !== undefined)
-		return lmo
-	return undefined
-}
-
-_etc.serializaition_filter = () => {
-	let _sequence_map = new Map()
-
-	return {
-		SequenceTest(obj) {
-			return _sequence_map.get(obj);
-		},
-		SequenceRegister(o, p) {
-			_sequence_map.set(o, p)
-			return undefined
-		},
-		Examine() {
-			return _sequence_map
-		},
-		Finalize() {
-			_sequence_map.clear()
-		}
-	}
-}
 
 _local.dunder_regex = /^__.+__$/g
-_local.marshalling_helper = (obj) => {
+_local.marshalling_helper = (obj, options) => {
 	if (obj === undefined || obj === null)
 		return _local._pyjs.$GetMarshaledObject(obj)
 
@@ -315,18 +272,38 @@ _local.marshalling_helper = (obj) => {
 	if (_local._pyjs.$IsInstanceOf(obj))
 		return obj
 	
-	return _local._pyjs.$GetMarshaledObject(obj)
+	return _local._pyjs.$GetMarshaledObject(obj, options)
 }
-_local.marshalling_option_helper = ({getReference}) => {
+_local.is_function_argument = (obj) => {
+	if (typeof obj !== 'function')
+		return false
+
+	let lmo = obj[_local.marshaled_object_tag]
+	return lmo === undefined || lmo.GetObjectType() == _etc.python_object_type.FUNCTION
+}
+_local.marshalling_option_helper = ({getReference, safeIntegerAsNumber, zeroCopyBytes, typedArrays,
+	numericArrays, dictAsObject, recordsAsColumns}) => {
 	return { 
-		getReference
+		getReference,
+		safeIntegerAsNumber,
+		zeroCopyBytes,
+		typedArrays,
+		numericArrays,
+		dictAsObject,
+		recordsAsColumns
 	}
 }
 _local.default_marshalling_modes = {
 	attributeCheck: true,
 	asyncOverride: false,
 	getReference: false,
-	getReferenceOnIterate: false
+	getReferenceOnIterate: false,
+	safeIntegerAsNumber: false,
+	zeroCopyBytes: false,
+	typedArrays: false,
+	numericArrays: false,
+	dictAsObject: false,
+	recordsAsColumns: false
 }
 
 _local.default_hidden_marshalling_modes = {
@@ -337,6 +314,78 @@ _local.default_hidden_marshalling_modes = {
 // Marshalling Proxy & Factory
 ////////////////////////////////////////////
 
+//Returned by GetAttributeOrMethod in place of function and method attributes.
+_local.method_marker = Symbol('method')
+
+//One getattr per access: methods come back as the marker and get a thunk, everything else is
+//marshalled as is. missingAsUndefined turns an AttributeError into undefined.
+//obj.method(..) therefore costs two native calls, this lookup and CallMethod; the lookup isn't
+//skipped for known methods since Python may rebind the attribute in between.
+_local.get_attribute = (func, k, missingAsUndefined) => {
+	let attr = func.py.GetAttributeOrMethod(k, 
+		_local.marshalling_option_helper(func._mode), _local.method_marker, missingAsUndefined === true)
+
+	if (attr !== _local.method_marker) {
+		//Python may have rebound a method to a plain value since the last access.
+		if (func._methods !== undefined)
+			func._methods.delete(k)
+		return _etc.marshalling_factory(attr)
+	}
+
+	if (func._methods === undefined)
+		func._methods = new Map()
+
+	let entry = func._methods.get(k)
+	if (entry === undefined) {
+		entry = _local.method_thunk(func, k)
+		func._methods.set(k, entry)
+	}
+	else
+		entry.reset()
+	return entry.thunk
+}
+
+//Stands in for the bound method func.k. Calling it is a single CallMethod; anything else
+//(modes, $async, passing it around) goes to the bound method proxy, created on first use.
+//reset() drops that proxy so the next use picks up whatever func.k is bound to by then.
+_local.method_thunk = (func, k) => {
+	let bound = undefined
+	const resolve = () => {
+		if (bound === undefined)
+			bound = _etc.marshalling_factory(func.py.GetAttribute(k, 
+				_local.marshalling_option_helper(func._mode)))
+		return bound
+	}
+
+	const handler = {
+		apply: (t, th, args) => {
+			if (args.some(_local.is_function_argument))
+				return resolve().$apply(args)
+
+			return _etc.marshalling_factory(func.py.CallMethod(k, args))
+		},
+		get: (t, key) => resolve()[key],
+		set: (t, key, val) => {
+			resolve()[key] = val
+			return true
+		},
+		has: (t, key) => key in resolve(),
+		ownKeys: (t) => Reflect.ownKeys(resolve()),
+		getOwnPropertyDescriptor: (t, key) => {
+			return {
+				enumerable: true,
+				configurable: true
+			}
+		}
+	}
+
+	//Lets native code pass the thunk to Python as the bound method without resolving it here.
+	return {
+		thunk: _local._pyjs.$TagMethodReference(new Proxy(() => undefined, handler), func.py, k),
+		reset: () => { bound = undefined }
+	}
+}
+
 _etc.marshalling_factory_cloner = (obj, {_mode, _hidden_mode}) => {
 	let lmo = obj[_local.marshaled_object_tag]
 	if (lmo === undefined)
@@ -374,10 +423,23 @@ _etc.marshalling_factory = (obj, modes) =>　{
 			if (!_etc.parameter_check.methods.array.f(args))
 				throw Error("Function invocation requires an array.")
 
+			//Without function arguments nothing needs the async checks below, so hand the raw
+			//values over and let native code convert them in one pass.
+			if (!args.some(_local.is_function_argument)
+				&& (dict === undefined || (_etc.parameter_check.methods.object.f(dict) 
+					&& !Object.values(dict).some(_local.is_function_argument)))
+				&& (t.py.IsCallable() || t.py.GetObjectType() == _etc.python_object_type.TYPE))
+			{
+				return _etc.marshalling_factory(t.py.FunctionCallRaw(args, dict,
+					_local.marshalling_option_helper(func._mode)))
+			}
+
+			//Only argument conversion reads recordsAsColumns; skip the options object otherwise.
+			let arg_options = func._mode.recordsAsColumns ? { recordsAsColumns: true } : undefined
 			let pyargs = []
 			for (let arg of args)
 			{
-				arg = _local.marshalling_helper(arg)
+				arg = _local.marshalling_helper(arg, arg_options)
 				if (arg.GetObjectType() == _etc.python_object_type.FUNCTION)
 					func._current_call.has_function = true
 
@@ -392,7 +454,7 @@ _etc.marshalling_factory = (obj, modes) =>　{
 
 				for (let key in dict)
 				{
-					let arg = _local.marshalling_helper(dict[key])
+					let arg = _local.marshalling_helper(dict[key], arg_options)
 					if (arg.GetObjectType() == _etc.python_object_type.FUNCTION)
 						func._current_call.has_function = true
 
@@ -433,6 +495,22 @@ _etc.marshalling_factory = (obj, modes) =>　{
 	}
 	//func.$call = func.$function_prototype(func).call
 	func.$apply = func.$_function_prototype(func)
+	//One native call over many argument arrays; failed calls leave their exception in place.
+	func.$map = (sets) => {
+		if (!_etc.parameter_check.methods.array.f(sets)
+			|| !sets.every(_etc.parameter_check.methods.array.f))
+			throw Error("Batched invocation requires an array of argument arrays.")
+
+		if (sets.some((args) => args.some(_local.is_function_argument)))
+			throw Error("Batched invocation does not support functions as parameters.")
+
+		let results = func.py.FunctionCallBatch(sets,
+			_local.marshalling_option_helper(func._mode))
+		for (let i = 0; i < results.length; i++)
+			results[i] = _etc.marshalling_factory(results[i])
+
+		return results
+	}
 	func.$toString = () => _local._pyjs.pyjs.base().str(func._p)
 	func.$isCallable = () => func.py.IsCallable()
 	func.$isClass = () => func.py.GetObjectType() 
@@ -475,11 +553,20 @@ _etc.marshalling_factory = (obj, modes) =>　{
 	}
 	
 	func.$mode = ({ attributeCheck = func._mode.attributeCheck, asyncOverride = func._mode.asyncOverride,
-		getReference = func._mode.getReference, getReferenceOnIterate = func._mode.getReferenceOnIterate } = {}) => {
+		getReference = func._mode.getReference, getReferenceOnIterate = func._mode.getReferenceOnIterate,
+		safeIntegerAsNumber = func._mode.safeIntegerAsNumber, zeroCopyBytes = func._mode.zeroCopyBytes,
+		typedArrays = func._mode.typedArrays, numericArrays = func._mode.numericArrays,
+		dictAsObject = func._mode.dictAsObject, recordsAsColumns = func._mode.recordsAsColumns } = {}) => {
 			func._mode.attributeCheck = attributeCheck
 			func._mode.asyncOverride = asyncOverride
 			func._mode.getReference = getReference
 			func._mode.getReferenceOnIterate = getReferenceOnIterate
+			func._mode.safeIntegerAsNumber = safeIntegerAsNumber
+			func._mode.zeroCopyBytes = zeroCopyBytes
+			func._mode.typedArrays = typedArrays
+			func._mode.numericArrays = numericArrays
+			func._mode.dictAsObject = dictAsObject
+			func._mode.recordsAsColumns = recordsAsColumns
 			return func._p
 	}
 	func.$hidden_mode = ({ explicitAsync = func._hidden_mode.explicitAsync, callback = undefined } = {}) => {
@@ -507,6 +594,10 @@ _etc.marshalling_factory = (obj, modes) =>　{
 		get: (t, k) => {
 			if (k === _local.marshaled_object_tag)
 				return t.py
+			//Methods already looked up skip the attribute list, but are still looked up again
+			//so a rebinding on the Python side is seen.
+			else if (func._methods !== undefined && func._methods.has(k))
+				return _local.get_attribute(func, k, func._mode.attributeCheck)
 			// node.js console.log output
 			else if (k === util.inspect.custom)
 			{
@@ -602,14 +693,11 @@ _etc.marshalling_factory = (obj, modes) =>　{
 			else if (_etc.parameter_check.methods.string.f(k)) {
 				if (func._mode.attributeCheck) {
 					if (t.py.GetAttributeList().includes(k)) {
-						return _etc.marshalling_factory(
-							t.py.GetAttribute(k, 
-								_local.marshalling_option_helper(func._mode)))
+						return _local.get_attribute(func, k)
 					}
 				}
 				else
-					return _etc.marshalling_factory(t.py.GetAttribute(k, 
-						_local.marshalling_option_helper(func._mode)))
+					return _local.get_attribute(func, k)
 			}
 
 			return undefined
@@ -618,6 +706,8 @@ _etc.marshalling_factory = (obj, modes) =>　{
 			//Will throw if an error occurs.
 			let obj = _local.marshalling_helper(val)
 			func.py.SetAttribute(attr, obj)
+			if (func._methods !== undefined)
+				func._methods.delete(attr)
 			return true
 		},
 		has: (t,k) => {
@@ -642,7 +732,8 @@ _etc.marshalling_factory = (obj, modes) =>　{
 		}
 	}
 
-	let p = new Proxy(func, handler)
+	//Lets native code unmarshal the proxy without a trip through the get trap.
+	let p = _local._pyjs.$TagMarshaledObject(new Proxy(func, handler), obj)
 	func._p = p
 
 	return p
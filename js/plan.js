@@ -0,0 +1,224 @@
+//////////////////////////////////////////////////////////////////////////
+//	py.js - Node.js/Python Bridge; Node.js-hosted Python.
+//	Copyright (C) 2019  Michael Brown
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as
+//	published by the Free Software Foundation, either version 3 of the
+//	License, or (at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//	Additional permission under the GNU Affero GPL version 3 section 7:
+//
+//	If you modify this Program, or any covered work, by linking or
+//	combining it with other code, such other code is not for that reason
+//	alone subject to any of the requirements of the GNU Affero GPL
+//	version 3.
+//////////////////////////////////////////////////////////////////////////
+
+'use strict'
+
+//Opcodes understood by NapiPyObject::ExecutePlan (pyjs_pyobj.cpp).
+const op = {
+	ARGUMENT: 0,
+	LITERAL: 1,
+	GETATTR: 2,
+	GETITEM: 3,
+	CALL: 4,
+	BUILD_LIST: 5,
+	BUILD_TUPLE: 6
+}
+
+const keywords = {
+	True: true,
+	False: false,
+	None: null
+}
+
+const escapes = {
+	n: '\n',
+	r: '\r',
+	t: '\t'
+}
+
+const token_regex = /\s*(?:([A-Za-z_][A-Za-z0-9_]*)|(\d+\.\d*(?:[eE][+-]?\d+)?|\d*\.\d+(?:[eE][+-]?\d+)?|\d+[eE][+-]?\d+)|(\d+)|('(?:[^'\\]|\\.)*'|"(?:[^"\\]|\\.)*")|([.,=()[\]-]))/y
+
+//Splits the template into tokens; each interpolation becomes a single value token.
+//Raw strings keep backslashes for the Python-style string literals below.
+let tokenize = (strings, values) => {
+	let tokens = []
+	for (let i = 0; i < strings.raw.length; i++) {
+		let s = strings.raw[i]
+		token_regex.lastIndex = 0
+		while (token_regex.lastIndex < s.length) {
+			let start = token_regex.lastIndex
+			let m = token_regex.exec(s)
+			if (m === null) {
+				if (s.slice(start).trim().length == 0)
+					break
+				throw Error(`Plan syntax error near '${s.slice(start).trim()}'.`)
+			}
+
+			if (m[1] !== undefined)
+				tokens.push(m[1] in keywords ? { value: keywords[m[1]] } : { name: m[1] })
+			else if (m[2] !== undefined)
+				tokens.push({ value: Number(m[2]) })
+			else if (m[3] !== undefined)
+				tokens.push({ value: BigInt(m[3]) }) //Python int, not float
+			else if (m[4] !== undefined)
+				tokens.push({ value: m[4].slice(1, -1)
+					.replace(/\\(.)/g, (e, c) => c in escapes ? escapes[c] : c) })
+			else
+				tokens.push({ punct: m[5] })
+		}
+
+		if (i < values.length)
+			tokens.push({ value: values[i] })
+	}
+	return tokens
+}
+
+//Compiles a Python-style chain of names, attribute/item access and calls into ExecutePlan ops.
+let compile = (params, strings, values) => {
+	let tokens = tokenize(strings, values)
+	let ops = []
+	let pos = 0
+
+	let peek = (punct) => pos < tokens.length && tokens[pos].punct === punct
+	let expect = (punct) => {
+		if (!peek(punct))
+			throw Error(`Plan syntax error. Expecting '${punct}'.`)
+		pos++
+	}
+
+	//Comma separated expressions up to the closing punct (a trailing comma is allowed).
+	let items = (close) => {
+		let count = 0
+		while (!peek(close)) {
+			expression()
+			count++
+			if (!peek(close))
+				expect(',')
+		}
+		pos++
+		return count
+	}
+
+	let expression = () => {
+		let t = tokens[pos++]
+		if (t === undefined)
+			throw Error("Plan syntax error. Unexpected end of expression.")
+
+		if (t.name !== undefined) {
+			let index = params.indexOf(t.name)
+			if (index < 0)
+				throw Error(`Plan syntax error. Unknown name '${t.name}'.`)
+			ops.push(op.ARGUMENT, index)
+		}
+		else if ('value' in t)
+			ops.push(op.LITERAL, t.value)
+		else if (t.punct === '-' && pos < tokens.length 
+			&& (typeof tokens[pos].value === 'number' || typeof tokens[pos].value === 'bigint'))
+			ops.push(op.LITERAL, -tokens[pos++].value)
+		else if (t.punct === '[')
+			ops.push(op.BUILD_LIST, items(']'))
+		else if (t.punct === '(') {
+			//(a) groups; (), (a,) and (a, b) are tuples, as in Python.
+			if (peek(')')) {
+				pos++
+				ops.push(op.BUILD_TUPLE, 0)
+			}
+			else {
+				expression()
+				if (peek(',')) {
+					pos++
+					ops.push(op.BUILD_TUPLE, 1 + items(')'))
+				}
+				else
+					expect(')')
+			}
+		}
+		else
+			throw Error(`Plan syntax error. Unexpected '${t.punct}'.`)
+
+		for (;;) {
+			if (peek('.')) {
+				pos++
+				let name = tokens[pos++]
+				if (name === undefined || name.name === undefined)
+					throw Error("Plan syntax error. Expecting an attribute name.")
+				ops.push(op.GETATTR, name.name)
+			}
+			else if (peek('[')) {
+				pos++
+				expression()
+				expect(']')
+				ops.push(op.GETITEM)
+			}
+			else if (peek('(')) {
+				pos++
+				let nargs = 0
+				let kwnames = []
+				while (!peek(')')) {
+					let t = tokens[pos]
+					if (t !== undefined && t.name !== undefined
+						&& pos + 1 < tokens.length && tokens[pos + 1].punct === '=') {
+						pos += 2
+						expression()
+						kwnames.push(t.name)
+					}
+					else if (kwnames.length > 0)
+						throw Error("Plan syntax error. Positional argument follows keyword argument.")
+					else {
+						expression()
+						nargs++
+					}
+
+					if (!peek(')'))
+						expect(',')
+				}
+				pos++
+				ops.push(op.CALL, nargs, kwnames.length > 0 ? kwnames : null)
+			}
+			else
+				return
+		}
+	}
+
+	expression()
+	if (pos < tokens.length)
+		throw Error("Plan syntax error. Unexpected trailing input.")
+
+	return ops
+}
+
+module.exports = (_pyjs, _etc) => {
+	let build = (params) => (strings, ...values) => {
+		let ops = compile(params, strings, values)
+		let plan = (...args) => _etc.marshalling_factory(
+			_pyjs.$ExecutePlan(ops, args))
+		plan.$newMode = (modes = {}) => {
+			let options = Object.assign({}, modes)
+			return (...args) => _etc.marshalling_factory(
+				_pyjs.$ExecutePlan(ops, args, options))
+		}
+		return plan
+	}
+
+	//plan`expr` or plan('a', 'b')`expr`: compiles expr once into a function of its named inputs.
+	return (...params) => {
+		if (Array.isArray(params[0]) && Array.isArray(params[0].raw))
+			return build([])(...params)
+
+		if (!params.every(_etc.parameter_check.methods.string.f))
+			throw Error("Plan parameters must be names.")
+		return build(params)
+	}
+}
@@ -33,12 +33,371 @@
 static PyObject* __pyjs_module_;
 static PyObject* __py__main__module_;
 
+////////////////////////////////////////////
+// Integer Marshalling (BigInt <-> PyLong)
+////////////////////////////////////////////
+
+//BigInt words are 64-bit limbs (host byte order), least significant first.
+//Python wants a little-endian byte string of the magnitude.
+static PyObject* PyLongFromBigIntWords(const uint64_t* words, size_t word_count, bool negative)
+{
+	const unsigned char* bytes;
+#if PY_LITTLE_ENDIAN
+	bytes = reinterpret_cast<const unsigned char*>(words);
+#else
+	std::vector<unsigned char> swapped(word_count * 8);
+	for (size_t i = 0; i < word_count; i++)
+		for (size_t b = 0; b < 8; b++)
+			swapped[i * 8 + b] = (unsigned char)(words[i] >> (8 * b));
+	bytes = swapped.data();
+#endif
+
+#if PY_VERSION_HEX >= 0x030D0000
+	PyObject* magnitude = PyLong_FromUnsignedNativeBytes(bytes, word_count * 8,
+		Py_ASNATIVEBYTES_LITTLE_ENDIAN); //PyLong_FromUnsignedNativeBytes (New)
+#else
+	PyObject* magnitude = _PyLong_FromByteArray(bytes, word_count * 8, 1, 0); //_PyLong_FromByteArray (New)
+#endif
+
+	if (!negative || magnitude == NULL)
+		return magnitude;
+
+	PyObject* obj = PyNumber_Negative(magnitude); //PyNumber_Negative (New)
+	Py_DECREF(magnitude);
+	return obj;
+}
+
+//Fills 'words' with the magnitude of obj. Returns false (with a Python error set) on failure.
+static bool PyLongToBigIntWords(PyObject* obj, bool negative, std::vector<uint64_t>& words)
+{
+	PyObject* magnitude = negative ? PyNumber_Negative(obj) : obj; //PyNumber_Negative (New)
+	if (magnitude == NULL)
+		return false;
+	if (!negative)
+		Py_INCREF(magnitude);
+
+#if PY_VERSION_HEX >= 0x030D0000
+	const int flags = Py_ASNATIVEBYTES_LITTLE_ENDIAN | Py_ASNATIVEBYTES_UNSIGNED_BUFFER;
+	Py_ssize_t byte_count = PyLong_AsNativeBytes(magnitude, NULL, 0, flags);
+	bool ok = byte_count >= 0;
+	if (ok)
+	{
+		words.assign(((size_t)byte_count + 7) / 8, 0);
+		ok = PyLong_AsNativeBytes(magnitude, words.data(), words.size() * 8, flags) >= 0;
+	}
+#else
+	size_t bit_count = _PyLong_NumBits(magnitude);
+	bool ok = !(bit_count == (size_t)-1 && PyErr_Occurred());
+	if (ok)
+	{
+		words.assign((bit_count + 63) / 64, 0);
+		ok = _PyLong_AsByteArray((PyLongObject*)magnitude,
+			reinterpret_cast<unsigned char*>(words.data()), words.size() * 8, 1, 0) == 0;
+	}
+#endif
+
+#if !PY_LITTLE_ENDIAN
+	for (auto& word : words)
+	{
+		const unsigned char* b = reinterpret_cast<const unsigned char*>(&word);
+		uint64_t le = 0;
+		for (size_t i = 0; i < 8; i++)
+			le |= (uint64_t)b[i] << (8 * i);
+		word = le;
+	}
+#endif
+
+	Py_DECREF(magnitude);
+	return ok;
+}
+
+static PyObject* Js_BigIntToPython(const Napi::Env env, napi_value val)
+{
+	NAPI_DIRECT_START(env);
+	int sign_bit = 0;
+	size_t word_count = 0;
+	NAPI_DIRECT_FUNC(napi_get_value_bigint_words, val, &sign_bit, &word_count, NULL);
+
+	//Single word values are the common case and don't need the heap.
+	if (word_count <= 1)
+	{
+		uint64_t word = 0;
+		word_count = 1;
+		NAPI_DIRECT_FUNC(napi_get_value_bigint_words, val, &sign_bit, &word_count, &word);
+		if (!sign_bit)
+			return PyLong_FromUnsignedLongLong(word); //PyLong_FromUnsignedLongLong (New)
+		else if (word <= (uint64_t)LLONG_MAX)
+			return PyLong_FromLongLong(-(long long)word); //PyLong_FromLongLong (New)
+		return PyLongFromBigIntWords(&word, 1, true);
+	}
+
+	std::vector<uint64_t> words(word_count);
+	NAPI_DIRECT_FUNC(napi_get_value_bigint_words, val, &sign_bit, &word_count, words.data());
+	return PyLongFromBigIntWords(words.data(), word_count, sign_bit != 0);
+}
+
+//Dates are plain objects to every other check, so ask the engine directly.
+static bool IsJsDate(const Napi::Env env, const Napi::Value val)
+{
+	bool is_date = false;
+	return napi_is_date(env, val, &is_date) == napi_ok && is_date;
+}
+
+//Largest integer a double represents exactly (Number.MAX_SAFE_INTEGER).
+static const long long MAX_SAFE_INTEGER = (1LL << 53) - 1;
+
+static Napi::Value Py_LongToJavascript(const Napi::Env env, PyObject* obj,
+	const pyjs::MarshallingOptions& marshalling_options)
+{
+	NAPI_DIRECT_START(env);
+	napi_value napi_bigint;
+
+	int overflow = 0;
+	long long value = PyLong_AsLongLongAndOverflow(obj, &overflow);
+	if (overflow == 0)
+	{
+		if (value == -1 && PyErr_Occurred())
+		{
+			pyjs_utils::ThrowPythonException(env);
+			return env.Undefined();
+		}
+
+		if (marshalling_options.safeIntegerAsNumber
+			&& value <= MAX_SAFE_INTEGER && value >= -MAX_SAFE_INTEGER)
+			return Napi::Number::New(env, (double)value);
+
+		NAPI_DIRECT_FUNC(napi_create_bigint_int64, value, &napi_bigint);
+		return Napi::Value(env, napi_bigint);
+	}
+
+	//Overflow carries the sign for us (-1 or 1).
+	std::vector<uint64_t> words;
+	if (!PyLongToBigIntWords(obj, overflow < 0, words))
+	{
+		pyjs_utils::ThrowPythonException(env);
+		return env.Undefined();
+	}
+
+	NAPI_DIRECT_FUNC(napi_create_bigint_words, overflow < 0 ? 1 : 0,
+		words.size(), words.data(), &napi_bigint);
+	return Napi::Value(env, napi_bigint);
+}
+
 ////////////////////////////////////////////
 // Javascript -> Python Marshalling
 ////////////////////////////////////////////
 
+std::vector<pyjs::MarshallingContext*> pyjs::MarshallingContext::pool_;
+
+pyjs::MarshallingContext::Lease::Lease(const Napi::Env env, const pyjs::MarshallingOptions& options)
+{
+	if (pool_.empty())
+	{
+		context_ = new MarshallingContext();
+	}
+	else
+	{
+		context_ = pool_.back();
+		pool_.pop_back();
+	}
+
+	context_->options = options;
+	context_->identities.Begin(env);
+}
+
+pyjs::MarshallingContext::Lease::~Lease()
+{
+	//Clearing keeps the containers' capacity for the next conversion.
+	context_->identities.Reset();
+	context_->python_to_javascript.clear();
+	pool_.push_back(context_);
+}
+
+void pyjs::JsIdentityTable::Begin(napi_env env)
+{
+	env_ = env;
+}
+
+void pyjs::JsIdentityTable::Reset()
+{
+	if (wrapped_.empty() && objects_.empty())
+		return;
+
+	//napi_remove_wrap refuses to run with an exception pending; set it aside meanwhile.
+	bool exception_pending = false;
+	napi_value exception = NULL;
+	napi_is_exception_pending(env_, &exception_pending);
+	if (exception_pending)
+		napi_get_and_clear_last_exception(env_, &exception);
+
+	for (napi_value val : wrapped_)
+	{
+		void* result;
+		napi_remove_wrap(env_, val, &result);
+	}
+
+	for (auto& ele : objects_)
+		Py_DECREF(ele.first); //Register (Clone)
+
+	wrapped_.clear();
+	unwrappable_.clear();
+	objects_.clear();
+
+	if (exception_pending)
+		napi_throw(env_, exception);
+}
+
+bool pyjs::JsIdentityTable::Find(napi_value val, PyObject** obj, PyObjectType* type)
+{
+	void* result = NULL;
+	if (napi_unwrap(env_, val, &result) == napi_ok)
+	{
+		//Objects may carry a wrap from elsewhere; only trust pointers registered here.
+		auto it = objects_.find(static_cast<PyObject*>(result));
+		if (it != objects_.end())
+		{
+			*obj = it->first;
+			*type = it->second;
+			return true;
+		}
+	}
+
+	for (auto& ele : unwrappable_)
+	{
+		bool equals = false;
+		if (napi_strict_equals(env_, val, ele.first, &equals) == napi_ok && equals)
+		{
+			*obj = ele.second;
+			*type = objects_[ele.second];
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void pyjs::JsIdentityTable::Register(napi_value val, PyObject* obj, PyObjectType type)
+{
+	//Hold our own reference so the pointer can't be reused while the table is alive.
+	Py_INCREF(obj);
+	objects_.emplace(obj, type);
+
+	if (napi_wrap(env_, val, obj, NULL, NULL, NULL) == napi_ok)
+		wrapped_.push_back(val);
+	else
+		unwrappable_.emplace_back(val, obj); //Already wrapped by someone else; compare by identity.
+}
+
+//Plain objects only; arrays, dates, buffers and marshalled Python values keep their own conversions.
+static bool IsJsRecord(const Napi::Env env, const Napi::Value val)
+{
+	napi_valuetype type;
+	if (napi_typeof(env, val, &type) != napi_ok || type != napi_object)
+		return false;
+
+	return !val.IsArray() && !val.IsTypedArray() && !val.IsArrayBuffer() && !val.IsBuffer() &&
+		!IsJsDate(env, val) && NapiPyObject::UnwrapMarshaled(env, val) == nullptr;
+}
+
+//Converts an array of objects sharing the first row's keys (in order) into a dict of column lists.
+//Returns false, with nothing left behind, when the rows don't share a schema.
+static bool Js_RecordsToColumns(const Napi::Env env, napi_value napi_array, uint32_t size,
+	pyjs::MarshallingContext& context, PyObject** result)
+{
+	napi_value napi_row;
+	napi_value napi_keys;
+	uint32_t width = 0;
+
+	if (size == 0 ||
+		napi_get_element(env, napi_array, 0, &napi_row) != napi_ok ||
+		!IsJsRecord(env, Napi::Value(env, napi_row)) ||
+		napi_get_property_names(env, napi_row, &napi_keys) != napi_ok ||
+		napi_get_array_length(env, napi_keys, &width) != napi_ok ||
+		width == 0)
+		return false;
+
+	std::vector<napi_value> keys(width);
+	for (uint32_t k = 0; k < width; k++)
+	{
+		napi_valuetype type;
+		if (napi_get_element(env, napi_keys, k, &keys[k]) != napi_ok ||
+			napi_typeof(env, keys[k], &type) != napi_ok || type != napi_string)
+			return false;
+	}
+
+	//Check every row against the schema before converting anything.
+	for (uint32_t i = 1; i < size; i++)
+	{
+		napi_value row_keys;
+		uint32_t row_width;
+		if (napi_get_element(env, napi_array, i, &napi_row) != napi_ok ||
+			!IsJsRecord(env, Napi::Value(env, napi_row)) ||
+			napi_get_property_names(env, napi_row, &row_keys) != napi_ok ||
+			napi_get_array_length(env, row_keys, &row_width) != napi_ok ||
+			row_width != width)
+			return false;
+
+		for (uint32_t k = 0; k < width; k++)
+		{
+			napi_value row_key;
+			bool equal = false;
+			if (napi_get_element(env, row_keys, k, &row_key) != napi_ok ||
+				napi_strict_equals(env, row_key, keys[k], &equal) != napi_ok || !equal)
+				return false;
+		}
+	}
+
+	PyObject* columns = PyDict_New(); //PyDict_New (New)
+	if (columns == NULL)
+		return false;
+
+	std::vector<PyObject*> lists(width);
+	for (uint32_t k = 0; k < width; k++)
+	{
+		PyObject* key = pyjs_utils::Js_StringToInternedKey(env, keys[k]); //Js_StringToInternedKey (New)
+		lists[k] = PyList_New(size); //PyList_New (New)
+		if (key == NULL || lists[k] == NULL || PyDict_SetItem(columns, key, lists[k]) < 0)
+		{
+			Py_XDECREF(key);
+			for (uint32_t j = 0; j <= k; j++)
+				Py_XDECREF(lists[j]);
+			Py_DECREF(columns);
+			PyErr_Clear();
+			return false;
+		}
+		Py_DECREF(key);
+		Py_DECREF(lists[k]); //Owned by columns from here on.
+	}
+
+	//Anything that refers back to the array sees the columns.
+	context.identities.Register(napi_array, columns, PyObjectType::Dictionary);
+
+	for (uint32_t i = 0; i < size; i++)
+	{
+		napi_get_element(env, napi_array, i, &napi_row);
+		for (uint32_t k = 0; k < width; k++)
+		{
+			napi_value napi_cell;
+			if (napi_get_property(env, napi_row, keys[k], &napi_cell) != napi_ok)
+				napi_get_undefined(env, &napi_cell);
+
+			//On failure the exception is pending; unfilled NULL slots are fine for list dealloc.
+			PyObject* cell = pyjs::Js_ConvertToPython(env, Napi::Value(env, napi_cell), context).first;
+			if (cell == NULL)
+			{
+				*result = columns;
+				return true;
+			}
+			PyList_SET_ITEM(lists[k], i, cell); //PyList_SET_ITEM (Steals)
+		}
+	}
+
+	*result = columns;
+	return true;
+}
+
 std::pair<PyObject*,PyObjectType> pyjs::Js_ConvertToPython(const Napi::Env env,
-	const Napi::Value val, const std::unique_ptr<const std::vector<Napi::Function>>& filters)
+	const Napi::Value val, pyjs::MarshallingContext& context)
 {
 	PyObject* obj = nullptr;
 	PyObjectType pot = PyObjectType::Unsupported;
@@ -52,27 +411,8 @@ std::pair<PyObject*,PyObjectType> pyjs::Js_ConvertToPython(const Napi::Env env,
 		return std::make_pair(obj, pot);
 	}
 
-	//Check to see if we have a JS proxy obj or Napi wrapper, if so return immediately.
+	//Primitives are classified first; only objects can be marshalled Python values.
 	NapiPyObject* _napi_obj_tmp;
-	if ((_napi_obj_tmp = pyjs::PyjsConfigurationOptions::AttemptNapiObjectUnmarshalling(env, val)))
-	{
-		obj = _napi_obj_tmp->GetPyObject(env);
-		Py_INCREF(obj); //Clone
-		return std::make_pair(obj,
-			_napi_obj_tmp->GetObjectTypeUnwrapped());
-	}
-	else if (NapiPyObject::IsInstanceOfNative(env, val))
-	{
-		_napi_obj_tmp = Napi::ObjectWrap<NapiPyObject>::Unwrap(val.As<Napi::Object>());
-		obj = _napi_obj_tmp->GetPyObject(env);
-		Py_INCREF(obj); //Clone
-		return std::make_pair(obj,
-			_napi_obj_tmp->GetObjectTypeUnwrapped());
-	}
-
-	//Further JS -> Python marshalling performed after this point.
-	obj = nullptr;
-
 	if (val.IsBoolean())
 	{
 		if (val.ToBoolean())
@@ -90,8 +430,7 @@ std::pair<PyObject*,PyObjectType> pyjs::Js_ConvertToPython(const Napi::Env env,
 	}
 	else if (val.Type() == napi_valuetype::napi_bigint)
 	{
-		//TODO: write a better conversion at some point here
-		obj = PyLong_FromString(val.ToString().Utf8Value().c_str(), NULL, 10); //PyLong_FromString (New)
+		obj = Js_BigIntToPython(env, val); //Js_BigIntToPython (New)
 		pot = PyObjectType::Integer;
 	}
 	else if (val.IsNumber())
@@ -102,57 +441,60 @@ std::pair<PyObject*,PyObjectType> pyjs::Js_ConvertToPython(const Napi::Env env,
 	}
 	else if (val.IsString())
 	{
-		obj = PyUnicode_FromString(val.As<Napi::String>().Utf8Value().c_str()); //PyUnicode_FromString (New)
+		obj = pyjs_utils::Js_StringToPyUnicode(env, val); //Js_StringToPyUnicode (New)
 		pot = PyObjectType::Unicode;
 	}
+	//A JS proxy obj or Napi wrapper, return the Python object it holds.
+	else if ((_napi_obj_tmp = NapiPyObject::UnwrapMarshaled(env, val)))
+	{
+		obj = _napi_obj_tmp->GetPyObject(env);
+		Py_INCREF(obj); //Clone
+		return std::make_pair(obj,
+			_napi_obj_tmp->GetObjectTypeUnwrapped());
+	}
+	//A method thunk, return the bound method it stands for.
+	else if (NapiPyObject::ResolveMethodReference(env, val, &obj))
+	{
+		pot = obj != NULL && PyMethod_Check(obj) ? PyObjectType::Method : PyObjectType::Function;
+		if (obj == NULL)
+		{
+			pyjs_utils::ThrowPythonException(env);
+			return std::make_pair(obj, pot);
+		}
+	}
 	else if (val.IsArray())
 	{
 		napi_value napi_array = Napi::Array(val.As<Napi::Array>());
 		NAPI_DIRECT_START(env);
-		//NAPI_SERIALIZATION_FILTER(filter, napi_array, obj);
 		uint32_t size;
 		pot = PyObjectType::List;
 
-		if (!filters->empty())
+		if (context.identities.Find(napi_array, &obj, &pot))
 		{
-			//Sequence Test
-			Napi::Value _filter_result = filters->operator[](0).Call({ napi_array });
-			if (!_filter_result.IsUndefined())
-			{
-				Napi::Object _napi_pyObject = _filter_result.As<Napi::Object>();
-				NapiPyObject* _npo = Napi::ObjectWrap<NapiPyObject>::Unwrap(_napi_pyObject);
-				obj = _npo->GetPyObject(env);
-				pot = _npo->GetObjectTypeUnwrapped();
-				Py_INCREF(obj); //Clone.
+			Py_INCREF(obj); //Clone.
+			return std::make_pair(obj, pot);
+		}
 
-				return std::make_pair(obj, pot);
-			}
-			//Sequence Register
-			else
-			{
-				NAPI_DIRECT_FUNC(napi_get_array_length, napi_array, &size);
-				obj = PyList_New(size); //PyList_New (New)
-				auto temp = NapiPyObject::NewInstance(env, {});
-				NapiPyObject* _npo = Napi::ObjectWrap<NapiPyObject>::Unwrap(temp);
-				_npo->SetPyObject(env, obj);
-				_npo->SetObjectType(pot);
-				Py_INCREF(obj);
-				Py_INCREF(obj); //NapiPyObject (Future Delete)
-				filters->operator[](1).Call({ napi_array, temp });
-			}
+		NAPI_DIRECT_FUNC(napi_get_array_length, napi_array, &size);
+
+		if (context.options.recordsAsColumns &&
+			Js_RecordsToColumns(env, napi_array, size, context, &obj)) //Js_RecordsToColumns (New)
+		{
+			pot = PyObjectType::Dictionary;
 		}
 		else
 		{
-			NAPI_DIRECT_FUNC(napi_get_array_length, napi_array, &size);
 			obj = PyList_New(size); //PyList_New (New)
-		}
+			context.identities.Register(napi_array, obj, pot);
 
-		for (uint32_t i = 0; i < size; i++)
-		{
-			napi_value napi_ele;
-			NAPI_DIRECT_FUNC(napi_get_element, napi_array, i, &napi_ele);
-			PyObject* ca = pyjs::Js_ConvertToPython(env, Napi::Value(env, napi_ele), filters).first;
-			PyList_SET_ITEM(obj, i, ca); //PyList_SET_ITEM (Steals)
+			//On failure the exception is pending; unfilled NULL slots are fine for list dealloc.
+			for (uint32_t i = 0; i < size && !env.IsExceptionPending(); i++)
+			{
+				napi_value napi_ele;
+				NAPI_DIRECT_FUNC(napi_get_element, napi_array, i, &napi_ele);
+				PyObject* ca = pyjs::Js_ConvertToPython(env, Napi::Value(env, napi_ele), context).first;
+				PyList_SET_ITEM(obj, i, ca); //PyList_SET_ITEM (Steals)
+			}
 		}
 	}
 	else if (val.IsFunction())
@@ -181,6 +523,12 @@ std::pair<PyObject*,PyObjectType> pyjs::Js_ConvertToPython(const Napi::Env env,
 
 		return std::make_pair(obj, pot);
 	}
+	else if (val.IsTypedArray() && !pyjs_buffer::IsByteTypedArray(env, val))
+	{
+		//Share the memory, keeping the element type.
+		obj = pyjs_buffer::Js_TypedArrayToPythonView(env, val); //Js_TypedArrayToPythonView (New)
+		pot = PyObjectType::Object;
+	}
 	else if (val.IsBuffer() || val.IsTypedArray())
 	{
 		auto data = Napi::Buffer<const char>(env, val);
@@ -189,49 +537,36 @@ std::pair<PyObject*,PyObjectType> pyjs::Js_ConvertToPython(const Napi::Env env,
 		obj = PyBytes_FromStringAndSize(bytes, data.Length()); //PyBytes_FromStringAndSize (New)
 		pot = PyObjectType::Bytes;
 	}
+	else if (IsJsDate(env, val))
+	{
+		obj = pyjs_utils::Js_DateToPyDateTime(env, val); //Js_DateToPyDateTime (New)
+		pot = PyObjectType::DateTime;
+		if (obj == NULL)
+		{
+			pyjs_utils::ThrowPythonException(env);
+			return std::make_pair(obj, pot);
+		}
+	}
 	else if (val.IsObject())
 	{
 		napi_value napi_obj = Napi::Object(val.As<Napi::Object>());
 		NAPI_DIRECT_START(env);
 		pot = PyObjectType::Object;
 
-		if (!filters->empty())
+		if (context.identities.Find(napi_obj, &obj, &pot))
 		{
-			//Sequence Test
-			Napi::Value _filter_result = filters->operator[](0).Call({ napi_obj });
-			if (!_filter_result.IsUndefined())
-			{
-				Napi::Object _napi_pyObject = _filter_result.As<Napi::Object>();
-				NapiPyObject* _npo = Napi::ObjectWrap<NapiPyObject>::Unwrap(_napi_pyObject);
-				obj = _npo->GetPyObject(env);
-				pot = _npo->GetObjectTypeUnwrapped();
-				Py_INCREF(obj); //Clone.
-
-				return std::make_pair(obj, pot);
-			}
-			//Sequence Register
-			else
-			{
-				obj = PyDict_New(); //PyDict_New (New)
-				auto temp = NapiPyObject::NewInstance(env, {});
-				NapiPyObject* _npo = Napi::ObjectWrap<NapiPyObject>::Unwrap(temp);
-				_npo->SetPyObject(env, obj);
-				_npo->SetObjectType(pot);
-				Py_INCREF(obj);
-				Py_INCREF(obj); //Register new, but allow NapiPiObject to handle memory.
-				filters->operator[](1).Call({ napi_obj, temp });
-			}
-		}
-		else
-		{
-			obj = PyDict_New(); //PyDict_New (New)
+			Py_INCREF(obj); //Clone.
+			return std::make_pair(obj, pot);
 		}
 
+		obj = PyDict_New(); //PyDict_New (New)
+		context.identities.Register(napi_obj, obj, pot);
+
 		napi_value napi_arr;
 		NAPI_DIRECT_FUNC(napi_get_property_names, napi_obj, &napi_arr);
 		uint32_t size;
 		NAPI_DIRECT_FUNC(napi_get_array_length, napi_arr, &size);
-		for (uint32_t i = 0; i < size; i++)
+		for (uint32_t i = 0; i < size && !env.IsExceptionPending(); i++)
 		{
 			napi_value napi_ele;
 			NAPI_DIRECT_FUNC(napi_get_element, napi_arr, i, &napi_ele);
@@ -245,14 +580,22 @@ std::pair<PyObject*,PyObjectType> pyjs::Js_ConvertToPython(const Napi::Env env,
 			}
 			else
 			{
-				key = PyUnicode_FromString(napiVal.As<Napi::String>().Utf8Value().c_str()); //PyUnicode_FromString (New)	
+				key = pyjs_utils::Js_StringToInternedKey(env, napiVal); //Js_StringToInternedKey (New)
+			}
+
+			//Surface the Python error here rather than leaving it set for some later call to trip over.
+			if (key == NULL)
+			{
+				pyjs_utils::ThrowPythonException(env);
+				break;
 			}
 
 			napi_value napi_val;
 			NAPI_DIRECT_FUNC(napi_get_property, napi_obj, napi_ele, &napi_val);
-			PyObject* res = pyjs::Js_ConvertToPython(env, Napi::Value(env, napi_val), filters).first;
-			PyDict_SetItem(obj, key, res); //PyDict_SetItem (Nothing)
-			Py_XDECREF(key);
+			PyObject* res = pyjs::Js_ConvertToPython(env, Napi::Value(env, napi_val), context).first;
+			if (res != NULL && PyDict_SetItem(obj, key, res) < 0) //PyDict_SetItem (Neutral)
+				pyjs_utils::ThrowPythonException(env);
+			Py_DECREF(key);
 			Py_XDECREF(res);
 		}
 	}
@@ -262,34 +605,17 @@ std::pair<PyObject*,PyObjectType> pyjs::Js_ConvertToPython(const Napi::Env env,
 		NAPI_ERROR(env, "Unable to marshal Javascript type 'Symbol' to Python.");
 	}
 
-	//Napi has no good way of returning if something is a Date type yet...
-	//instanceof is unreliable in some cases
-	PyJsSpecialObjectType special_type = 
-		pyjs::PyjsConfigurationOptions::CheckJSSpecialType(val); 
-
-	if (special_type == PyJsSpecialObjectType::JSDateTime)
-	{
-		auto callback = NapiPyObject::serialization_callback_.Call(
-			{
-				Napi::Number::New(env, PyObjectType::_JS_DateTime),
-				val
-			}
-		);
-
-		NapiPyObject* _npo = Napi::ObjectWrap<NapiPyObject>::Unwrap(callback.As<Napi::Object>());
-		obj = _npo->GetPyObject(env);
-		Py_INCREF(obj); //Clone.
-
-		pot = PyObjectType::DateTime;
-	}
-	else if (obj == nullptr) //This shouldn't happen.
+	if (obj == nullptr && !env.IsExceptionPending()) //This shouldn't happen.
 	{
 		NAPI_ERROR(env, "Unable to marshal unknown Javascript type.");
 	}
 
+	//Containers registered in the identity table keep its reference until the lease ends;
+	//callers only ever see NULL alongside a pending exception.
 	if (env.IsExceptionPending())
 	{
 		Py_XDECREF(obj);
+		obj = NULL;
 	}
 
 	return std::make_pair(obj, pot);
@@ -299,10 +625,109 @@ std::pair<PyObject*,PyObjectType> pyjs::Js_ConvertToPython(const Napi::Env env,
 // Python -> Javascript Marshalling
 ////////////////////////////////////////////
 
+//Builtin collection constructors and methods, cached so Map/Set can be populated natively.
+static Napi::FunctionReference js_map_constructor_;
+static Napi::FunctionReference js_map_set_;
+static Napi::FunctionReference js_set_constructor_;
+static Napi::FunctionReference js_set_add_;
+
+static void InitNativeCollections(Napi::Env env)
+{
+	Napi::Function map = env.Global().Get("Map").As<Napi::Function>();
+	Napi::Function set = env.Global().Get("Set").As<Napi::Function>();
+	Napi::Object map_proto = map.Get("prototype").As<Napi::Object>();
+	Napi::Object set_proto = set.Get("prototype").As<Napi::Object>();
+
+	js_map_constructor_ = Napi::Persistent(map);
+	js_map_constructor_.SuppressDestruct();
+	js_map_set_ = Napi::Persistent(map_proto.Get("set").As<Napi::Function>());
+	js_map_set_.SuppressDestruct();
+	js_set_constructor_ = Napi::Persistent(set);
+	js_set_constructor_.SuppressDestruct();
+	js_set_add_ = Napi::Persistent(set_proto.Get("add").As<Napi::Function>());
+	js_set_add_.SuppressDestruct();
+}
+
+//Only NapiPyObject instances need a JS proxy; primitives and plain JS values are stored as-is.
+static bool NeedsMarshalingWrap(const Napi::Env env, napi_value val)
+{
+	napi_valuetype type;
+	if (napi_typeof(env, val, &type) != napi_ok || type != napi_object)
+		return false;
+
+	return NapiPyObject::IsInstanceOfNative(env, Napi::Value(env, val));
+}
+
+//Wraps the NapiPyObject elements of a container with a single call into JS.
+static void WrapMarshaledElements(const Napi::Env env, napi_value napi_array,
+	const std::vector<uint32_t>& indices)
+{
+	if (indices.empty())
+		return;
+
+	NAPI_DIRECT_START(env);
+	napi_value napi_batch;
+	NAPI_DIRECT_FUNC(napi_create_array_with_length, indices.size(), &napi_batch);
+
+	for (uint32_t i = 0; i < indices.size(); i++)
+	{
+		napi_value napi_ele;
+		NAPI_DIRECT_FUNC(napi_get_element, napi_array, indices[i], &napi_ele);
+		NAPI_DIRECT_FUNC(napi_set_element, napi_batch, i, napi_ele);
+	}
+
+	Napi::Value wrapped = NapiPyObject::serialization_callback_.Call(
+	{
+		Napi::Number::New(env, PyObjectType::_JS_Wrap),
+		napi_batch
+	});
+
+	if (env.IsExceptionPending())
+		return;
+
+	napi_value napi_wrapped = wrapped;
+	for (uint32_t i = 0; i < indices.size(); i++)
+	{
+		napi_value napi_ele;
+		NAPI_DIRECT_FUNC(napi_get_element, napi_wrapped, i, &napi_ele);
+		NAPI_DIRECT_FUNC(napi_set_element, napi_array, indices[i], napi_ele);
+	}
+}
+
+//As above, for values collected natively (e.g. Map/Set entries) rather than in an array.
+static void WrapMarshaledValues(const Napi::Env env, std::vector<napi_value>& values,
+	const std::vector<uint32_t>& indices)
+{
+	if (indices.empty())
+		return;
+
+	NAPI_DIRECT_START(env);
+	napi_value napi_batch;
+	NAPI_DIRECT_FUNC(napi_create_array_with_length, indices.size(), &napi_batch);
+
+	for (uint32_t i = 0; i < indices.size(); i++)
+	{
+		NAPI_DIRECT_FUNC(napi_set_element, napi_batch, i, values[indices[i]]);
+	}
+
+	Napi::Value wrapped = NapiPyObject::serialization_callback_.Call(
+	{
+		Napi::Number::New(env, PyObjectType::_JS_Wrap),
+		napi_batch
+	});
+
+	if (env.IsExceptionPending())
+		return;
+
+	napi_value napi_wrapped = wrapped;
+	for (uint32_t i = 0; i < indices.size(); i++)
+	{
+		NAPI_DIRECT_FUNC(napi_get_element, napi_wrapped, i, &values[indices[i]]);
+	}
+}
+
 Napi::Value pyjs::Py_ConvertToJavascript(const Napi::Env env, PyObject* obj,
-	const std::unique_ptr<const std::vector<Napi::Function>>& filters,
-	std::unique_ptr<std::unordered_map<PyObject*,napi_value>>& python_to_javascript_map,
-	const pyjs::MarshallingOptions& marshalling_options)
+	pyjs::MarshallingContext& context)
 {
 	PY_CHECK_START();
 	Napi::Value napiValue = env.Null();
@@ -316,19 +741,15 @@ Napi::Value pyjs::Py_ConvertToJavascript(const Napi::Env env, PyObject* obj,
 	{
 		napiValue = env.Null();
 	}
+	//Javascript TypedArray View
+	else if (pyjs_buffer::IsJsBufferView(obj))
+	{
+		napiValue = pyjs_buffer::JsBufferViewToJavascript(env, obj);
+	}
 	//Integer
 	else if (PyLong_CheckExact(obj))
 	{
-		//TODO: Create a faster/better conversion in the future.
-		PyObject* str = PyObject_Str(obj); //PyObject_Str (New)
-		std::string strs = PyUnicode_AsUTF8(str);
-		napiValue = NapiPyObject::serialization_callback_.Call(
-			{
-				Napi::Number::New(env, PyObjectType::Integer),
-				Napi::String::New(env, strs.c_str())
-			}
-		);
-		Py_DECREF(str);
+		napiValue = Py_LongToJavascript(env, obj, context.options);
 	}
 	//Boolean
 	else if (PyBool_Check(obj))
@@ -348,6 +769,13 @@ Napi::Value pyjs::Py_ConvertToJavascript(const Napi::Env env, PyObject* obj,
 		//This should work, but Python seems to be platform specific.
 		napiValue = Napi::Number::New(env, PyFloat_AsDouble(obj));
 	}
+	//Datetime
+	else if (pyjs_utils::Py_IsDateTime(obj))
+	{
+		napi_value napi_date = pyjs_utils::Py_DateTimeToNapiDate(env, obj);
+		PY_CHECK(env, napi_date, nullptr, env.Undefined());
+		napiValue = Napi::Value(env, napi_date);
+	}
 	//Complex Number
 	else if (PyComplex_CheckExact(obj))
 	{
@@ -370,173 +798,258 @@ Napi::Value pyjs::Py_ConvertToJavascript(const Napi::Env env, PyObject* obj,
 	//Bytes
 	else if (PyBytes_CheckExact(obj))
 	{
-		//Copy these by default, and then let the user decide if they want to get the raw pointers, no copy.
-		/*char* bytes = PyBytes_AsString(obj);
-		NapiPyObjectHelperContainer<char>* container = new NapiPyObjectHelperContainer<char>(obj);
-		auto finalizer = [container](Napi::Env e, char* b) {
-			container->Finalize(e,b);
-		};
-		napiValue = Napi::Buffer<char>::New(env, bytes, PyBytes_Size(obj), finalizer);*/
-
-		char* bytes = PyBytes_AS_STRING(obj); //TODO: can this fail? check above too
-		napiValue = Napi::Buffer<char>::Copy(env, bytes, PyBytes_Size(obj));
+		//Always copied, even with zeroCopyBytes: bytes are immutable and a Buffer can't be made read-only.
+		char* bytes = PyBytes_AS_STRING(obj);
+		napiValue = Napi::Buffer<char>::Copy(env, bytes, PyBytes_GET_SIZE(obj));
 	}
 	//Byte Array
 	else if (PyByteArray_CheckExact(obj))
 	{
-		char* bytes = PyByteArray_AS_STRING(obj); //TODO: can this fail? check above too
-		napiValue = Napi::Buffer<char>::Copy(env, bytes, PyByteArray_Size(obj));
+		//Copy these by default, and then let the user decide if they want to share the memory.
+		if (context.options.zeroCopyBytes)
+		{
+			napiValue = pyjs_buffer::Py_BytesToExternalBuffer(env, obj);
+		}
+		else
+		{
+			char* bytes = PyByteArray_AS_STRING(obj);
+			napiValue = Napi::Buffer<char>::Copy(env, bytes, PyByteArray_GET_SIZE(obj));
+		}
 	}
 	//Unicode
 	else if (PyUnicode_CheckExact(obj))
 	{
-		std::string str = PyUnicode_AsUTF8(obj);
-		napiValue = Napi::String::New(env, str.c_str());
+		napi_value napi_string = pyjs_utils::Py_UnicodeToCachedNapiString(env, obj);
+		PY_CHECK(env, napi_string, NULL, env.Undefined());
+		napiValue = Napi::Value(env, napi_string);
 	}
 	//Tuple
 	else if (PyTuple_CheckExact(obj))
 	{
-		auto it = python_to_javascript_map->find(obj);
-		if (it != python_to_javascript_map->end())
+		auto it = context.python_to_javascript.find(obj);
+		if (it != context.python_to_javascript.end())
 		{
 			return Napi::Value(env, it->second);
 		}
 
+		if (context.options.numericArrays &&
+			pyjs_buffer::Py_SequenceToTypedArray(env, obj, napiValue))
+		{
+			context.python_to_javascript.insert(std::make_pair(obj, napiValue));
+			return napiValue;
+		}
+
 		NAPI_DIRECT_START(env);
 		napi_value napi_array;
 		Py_ssize_t size = PyTuple_GET_SIZE(obj);
 		NAPI_DIRECT_FUNC(napi_create_array_with_length, size, &napi_array);
 
-		python_to_javascript_map->insert(std::make_pair(obj, napi_array));
+		context.python_to_javascript.insert(std::make_pair(obj, napi_array));
 
+		std::vector<uint32_t> wrap_indices;
 		for (Py_ssize_t i = 0; i < size; i++)
 		{
 			PyObject* itm = PyTuple_GET_ITEM(obj, i); //PyTuple_GET_ITEM (Borrowed)
 			Napi::Value val;
-			val = Py_ConvertToJavascript(env, itm, filters, 
-				python_to_javascript_map, marshalling_options);
-
-			val = NapiPyObject::serialization_callback_.Call(
-			{
-				Napi::Number::New(env, PyObjectType::_JS_Wrap),
-				val
-			});
+			val = Py_ConvertToJavascript(env, itm, context);
 
 			NAPI_DIRECT_FUNC(napi_set_element, napi_array, i, val);
+			if (NeedsMarshalingWrap(env, val))
+				wrap_indices.push_back(static_cast<uint32_t>(i));
 		}
 
+		WrapMarshaledElements(env, napi_array, wrap_indices);
+
 		napiValue = Napi::Value(env, napi_array);
 	}
 	//List
 	else if (PyList_CheckExact(obj))
 	{
-		auto it = python_to_javascript_map->find(obj);
-		if (it != python_to_javascript_map->end())
+		auto it = context.python_to_javascript.find(obj);
+		if (it != context.python_to_javascript.end())
 		{
 			return Napi::Value(env, it->second);
 		}
 
+		if (context.options.numericArrays &&
+			pyjs_buffer::Py_SequenceToTypedArray(env, obj, napiValue))
+		{
+			context.python_to_javascript.insert(std::make_pair(obj, napiValue));
+			return napiValue;
+		}
+
 		NAPI_DIRECT_START(env);
 		napi_value napi_array;
 		Py_ssize_t size = PyList_Size(obj);
 		NAPI_DIRECT_FUNC(napi_create_array_with_length, size, &napi_array);
 
-		python_to_javascript_map->insert(std::make_pair(obj, napi_array));
+		context.python_to_javascript.insert(std::make_pair(obj, napi_array));
 
+		std::vector<uint32_t> wrap_indices;
 		for (Py_ssize_t i = 0; i < size; i++)
 		{
 			PyObject* itm = PyList_GET_ITEM(obj, i); //PyList_GET_ITEM (Borrowed)
-			Napi::Value val = Py_ConvertToJavascript(env, itm, filters,
-				python_to_javascript_map, marshalling_options);
-
-			val = NapiPyObject::serialization_callback_.Call(
-			{
-				Napi::Number::New(env, PyObjectType::_JS_Wrap),
-				val
-			});
+			Napi::Value val = Py_ConvertToJavascript(env, itm, context);
 
 			NAPI_DIRECT_FUNC(napi_set_element, napi_array, i, val);
+			if (NeedsMarshalingWrap(env, val))
+				wrap_indices.push_back(static_cast<uint32_t>(i));
 		}
 
+		WrapMarshaledElements(env, napi_array, wrap_indices);
+
 		napiValue = Napi::Value(env, napi_array);
 	}
 	//Dictionary
 	else if (PyDict_CheckExact(obj))
 	{
-		auto it = python_to_javascript_map->find(obj);
-		if (it != python_to_javascript_map->end())
+		auto it = context.python_to_javascript.find(obj);
+		if (it != context.python_to_javascript.end())
 		{
 			return Napi::Value(env, it->second);
 		}
 
-		Napi::Value map = NapiPyObject::serialization_callback_.Call(
+		NAPI_DIRECT_START(env);
+
+		if (context.options.dictAsObject)
 		{
-			Napi::Number::New(env, PyObjectType::Dictionary),
-			env.Null()
-		});
+			//Only dicts whose keys are all strings can become plain objects.
+			std::vector<std::pair<PyObject*, PyObject*>> props;
+			props.reserve(PyDict_GET_SIZE(obj));
+
+			Py_ssize_t pos = 0;
+			PyObject *key, *val;
+			while (PyDict_Next(obj, &pos, &key, &val) && PyUnicode_CheckExact(key)) //PyDict_Next (Borrow)
+				props.emplace_back(key, val);
+
+			if (props.size() == static_cast<size_t>(PyDict_GET_SIZE(obj)))
+			{
+				napi_value napi_object;
+				NAPI_DIRECT_FUNC(napi_create_object, &napi_object);
+
+				context.python_to_javascript.insert(std::make_pair(obj, napi_object));
+
+				//Properties keep the dict's insertion order. Dicts built with the same keys in the
+				//same order (e.g. records) still share a hidden class; differently ordered ones don't.
+				std::vector<napi_value> values;
+				std::vector<uint32_t> wrap_indices;
+				std::vector<napi_property_descriptor> descriptors(props.size());
+				values.reserve(props.size());
+
+				for (size_t i = 0; i < props.size(); i++)
+				{
+					Napi::Value n_val = Py_ConvertToJavascript(env, props[i].second, context);
 
-		python_to_javascript_map->insert(std::make_pair(obj, map));
+					if (NeedsMarshalingWrap(env, n_val))
+						wrap_indices.push_back(static_cast<uint32_t>(values.size()));
+					values.push_back(n_val);
+
+					descriptors[i].name = Py_ConvertToJavascript(env, props[i].first, context);
+					descriptors[i].attributes = static_cast<napi_property_attributes>(
+						napi_writable | napi_enumerable | napi_configurable);
+				}
+
+				WrapMarshaledValues(env, values, wrap_indices);
+
+				for (size_t i = 0; i < props.size(); i++)
+					descriptors[i].value = values[i];
+
+				if (!env.IsExceptionPending() && !descriptors.empty())
+				{
+					NAPI_DIRECT_FUNC(napi_define_properties, napi_object,
+						descriptors.size(), descriptors.data());
+				}
+
+				return Napi::Value(env, napi_object);
+			}
+		}
+
+		napi_value napi_map = js_map_constructor_.New({});
+
+		context.python_to_javascript.insert(std::make_pair(obj, napi_map));
+
+		//Keys and values interleaved, so proxies can be created with one batched call.
+		std::vector<napi_value> entries;
+		std::vector<uint32_t> wrap_indices;
+		entries.reserve(PyDict_GET_SIZE(obj) * 2);
 
 		Py_ssize_t pos = 0;
 		PyObject *key, *val;
 
 		while (PyDict_Next(obj, &pos, &key, &val)) //PyDict_Next (Borrow)
 		{
-			Napi::Value n_key = Py_ConvertToJavascript(env, key, filters, 
-				python_to_javascript_map, marshalling_options);
-			Napi::Value n_val = Py_ConvertToJavascript(env, val, filters, 
-				python_to_javascript_map, marshalling_options);
+			Napi::Value n_key = Py_ConvertToJavascript(env, key, context);
+			Napi::Value n_val = Py_ConvertToJavascript(env, val, context);
+
+			if (NeedsMarshalingWrap(env, n_key))
+				wrap_indices.push_back(static_cast<uint32_t>(entries.size()));
+			entries.push_back(n_key);
+			if (NeedsMarshalingWrap(env, n_val))
+				wrap_indices.push_back(static_cast<uint32_t>(entries.size()));
+			entries.push_back(n_val);
+		}
 
-			NapiPyObject::serialization_callback_.Call(
-			{
-				Napi::Number::New(env, PyObjectType::Dictionary),
-				map,
-				n_key,
-				n_val
-			});
+		WrapMarshaledValues(env, entries, wrap_indices);
+
+		napi_value map_set = js_map_set_.Value();
+		for (size_t i = 0; i < entries.size() && !env.IsExceptionPending(); i += 2)
+		{
+			napi_value result;
+			NAPI_DIRECT_FUNC(napi_call_function, napi_map, map_set, 2, &entries[i], &result);
 		}
 
-		napiValue = map;
+		napiValue = Napi::Value(env, napi_map);
 	}
 	//Set
 	else if (PyAnySet_CheckExact(obj))
 	{
-		auto it = python_to_javascript_map->find(obj);
-		if (it != python_to_javascript_map->end())
+		auto it = context.python_to_javascript.find(obj);
+		if (it != context.python_to_javascript.end())
 		{
 			return Napi::Value(env, it->second);
 		}
 
-		auto size = PySet_GET_SIZE(obj);
-		auto list = PySequence_List(obj); //PySequence_List (New)
 		NAPI_DIRECT_START(env);
-		napi_value napi_array;
-		NAPI_DIRECT_FUNC(napi_create_array_with_length, size, &napi_array);
+		napi_value napi_set = js_set_constructor_.New({});
 
-		python_to_javascript_map->insert(std::make_pair(obj, napi_array));
+		context.python_to_javascript.insert(std::make_pair(obj, napi_set));
 
-		for (Py_ssize_t i = 0; i < size; i++)
+		PyObject* iter = PyObject_GetIter(obj); //PyObject_GetIter (New)
+		PY_CHECK(env, iter, NULL, env.Undefined());
+
+		std::vector<napi_value> items;
+		std::vector<uint32_t> wrap_indices;
+		items.reserve(PySet_GET_SIZE(obj));
+
+		PyObject* itm;
+		while ((itm = PyIter_Next(iter)) != NULL) //PyIter_Next (New)
 		{
-			PyObject* itm = PySequence_Fast_GET_ITEM(list, i); //PySequence_Fast_GET_ITEM (Borrowed)
-			Napi::Value val = Py_ConvertToJavascript(env, itm, filters,
-				python_to_javascript_map, marshalling_options);
+			Napi::Value val = Py_ConvertToJavascript(env, itm, context);
+			Py_DECREF(itm);
 
-			val = NapiPyObject::serialization_callback_.Call(
-			{
-				Napi::Number::New(env, PyObjectType::_JS_Wrap),
-				val
-			});
+			if (NeedsMarshalingWrap(env, val))
+				wrap_indices.push_back(static_cast<uint32_t>(items.size()));
+			items.push_back(val);
+		}
 
-			NAPI_DIRECT_FUNC(napi_set_element, napi_array, i, val);
+		Py_DECREF(iter);
+
+		if (PyErr_Occurred())
+		{
+			pyjs_utils::ThrowPythonException(env);
+			return env.Undefined();
 		}
 
-		Py_DECREF(list);
+		WrapMarshaledValues(env, items, wrap_indices);
 
-		napiValue = NapiPyObject::serialization_callback_.Call(
+		napi_value set_add = js_set_add_.Value();
+		for (size_t i = 0; i < items.size() && !env.IsExceptionPending(); i++)
 		{
-			Napi::Number::New(env, PyObjectType::Set),
-			napi_array
-		});
+			napi_value result;
+			NAPI_DIRECT_FUNC(napi_call_function, napi_set, set_add, 1, &items[i], &result);
+		}
+
+		napiValue = Napi::Value(env, napi_set);
 	}
 	//Instance Method
 	else if (PyInstanceMethod_Check(obj))
@@ -553,11 +1066,17 @@ Napi::Value pyjs::Py_ConvertToJavascript(const Napi::Env env, PyObject* obj,
 	{
 		NAPI_ERROR(env, "Python Type (<class 'code'>) is not currently supported.");
 	}
+	//Numeric Buffer Exporters (e.g. numpy.ndarray, array.array)
+	else if (context.options.typedArrays &&
+		pyjs_buffer::Py_BufferToTypedArray(env, obj, napiValue))
+	{
+		//napiValue set by Py_BufferToTypedArray.
+	}
 	//Send to marshaller as object
 	else
 	{
-		auto it = python_to_javascript_map->find(obj);
-		if (it != python_to_javascript_map->end())
+		auto it = context.python_to_javascript.find(obj);
+		if (it != context.python_to_javascript.end())
 		{
 			return Napi::Value(env, it->second);
 		}
@@ -577,7 +1096,7 @@ Napi::Value pyjs::Py_ConvertToJavascript(const Napi::Env env, PyObject* obj,
 
 		Py_INCREF(obj); //NapiPyObject (Future Delete)
 
-		python_to_javascript_map->insert(std::make_pair(obj, napiValue));
+		context.python_to_javascript.insert(std::make_pair(obj, napiValue));
 	}
 
 	return napiValue;
@@ -587,95 +1106,19 @@ Napi::Value pyjs::Py_ConvertToJavascript(const Napi::Env env, PyObject* obj,
 // Configuration Options & Filters
 ////////////////////////////////////////////
 
-Napi::FunctionReference
-	pyjs::PyjsConfigurationOptions::js_type_checking_callback_;
-
-Napi::FunctionReference
-	pyjs::PyjsConfigurationOptions::serialization_filter_callback_;
-
-Napi::FunctionReference
-	pyjs::PyjsConfigurationOptions::unmarshalling_filter_callback_;
-
 std::unique_ptr<napi_ext::ThreadSafeCallback>
 	pyjs::PyjsConfigurationOptions::debug_messaging_callback_;
 
-const std::unique_ptr<const std::vector<Napi::Function>>
-	pyjs::PyjsConfigurationOptions::GetSerializationFilters()
-{
-	std::unique_ptr<std::vector<Napi::Function>> filters(new std::vector<Napi::Function>());
-	Napi::Value filter_object_ = pyjs::PyjsConfigurationOptions::serialization_filter_callback_
-		.Call({ });
-
-	if (!filter_object_.IsUndefined())
-	{
-		Napi::Object obj = filter_object_.As<Napi::Object>();
-		filters->emplace_back(obj.Get("SequenceTest").As<Napi::Function>());
-		filters->emplace_back(obj.Get("SequenceRegister").As<Napi::Function>());
-		filters->emplace_back(obj.Get("Finalize").As<Napi::Function>());
-	}
-
-	return filters;
-}
-
-Napi::Value pyjs::PyjsConfigurationOptions::SetJSTypeCheckingCallback(const Napi::CallbackInfo &info)
-{
-	Napi::Env env = info.Env();
-	js_type_checking_callback_ = Napi::Persistent(info[0].As<Napi::Function>());
-	js_type_checking_callback_.SuppressDestruct();
-	return env.Undefined();
-}
-
-Napi::Value pyjs::PyjsConfigurationOptions::SetSerializationFiltersConstructor(const Napi::CallbackInfo &info)
-{
-	Napi::Env env = info.Env();
-	//Don't set this more than once...
-	serialization_filter_callback_ = Napi::Persistent(info[0].As<Napi::Function>());
-	serialization_filter_callback_.SuppressDestruct();
-	return env.Undefined();
-}
-
 Napi::Object pyjs::PyjsConfigurationOptions::Init(Napi::Env env, Napi::Object exports)
 {
-	exports.Set("$SetJSTypeCheckingCallback", 
-		Napi::Function::New(env, pyjs::PyjsConfigurationOptions::SetJSTypeCheckingCallback));
-	exports.Set("$SetUnmarshallingFilter",
-		Napi::Function::New(env, pyjs::PyjsConfigurationOptions::SetUnmarshallingFilter));
 	exports.Set("$SetSerializationCallbackConstructor",
 		Napi::Function::New(env, NapiPyObject::SetSerializationCallBackConstructor));
-	exports.Set("$SetSerializationFilterConstructor",
-		Napi::Function::New(env, pyjs::PyjsConfigurationOptions::SetSerializationFiltersConstructor));
 	exports.Set("$SetDebugMessagingCallback",
 		Napi::Function::New(env, pyjs::PyjsConfigurationOptions::SetDebugMessagingCallback));
 
 	return exports;
 }
 
-Napi::Value pyjs::PyjsConfigurationOptions::SetUnmarshallingFilter(const Napi::CallbackInfo &info)
-{
-	Napi::Env env = info.Env();
-	unmarshalling_filter_callback_ = Napi::Persistent(info[0].As<Napi::Function>());
-	unmarshalling_filter_callback_.SuppressDestruct();
-	return env.Undefined();
-}
-
-NapiPyObject* pyjs::PyjsConfigurationOptions::AttemptNapiObjectUnmarshalling(Napi::Env env, Napi::Value obj)
-{
-	Napi::Value filter_output_ = pyjs::PyjsConfigurationOptions::unmarshalling_filter_callback_
-		.Call({ obj });
-
-	if (!filter_output_.IsUndefined())
-	{
-		return Napi::ObjectWrap<NapiPyObject>::Unwrap(filter_output_.As<Napi::Object>());
-	}
-	else
-		return NULL;
-}
-
-PyJsSpecialObjectType pyjs::PyjsConfigurationOptions::CheckJSSpecialType(const Napi::Value val)
-{
-	return (PyJsSpecialObjectType)js_type_checking_callback_.Call({ val }).ToNumber().Int32Value();
-}
-
 Napi::Value pyjs::PyjsConfigurationOptions::SetDebugMessagingCallback(const Napi::CallbackInfo &info)
 {
 	Napi::Env env = info.Env();
@@ -727,61 +1170,163 @@ static Napi::Value Import(const Napi::CallbackInfo &info)
 
 	PY_CHECK_START();
 	//module_name = PyUnicode_DecodeFSDefault(info[0].ToString().Utf8Value().c_str());
-	module_name = PyUnicode_FromString(info[0].ToString().Utf8Value().c_str()); //PyUnicode_FromString (New)
+	module_name = pyjs_utils::Js_StringToPyUnicode(env, info[0].ToString()); //Js_StringToPyUnicode (New)
+	PY_CHECK(env, module_name, NULL, env.Undefined());
 	module = PyImport_Import(module_name); //PyImport_Import (New)
 	Py_XDECREF(module_name);
 
 	PY_CHECK(env, module, NULL, env.Undefined());
 
-	auto map = std::unique_ptr<std::unordered_map<PyObject*,napi_value>>
-		(new std::unordered_map<PyObject*,napi_value>());
-
-	Napi::Value napiValue = pyjs::Py_ConvertToJavascript(env, module,
-		pyjs::PyjsConfigurationOptions::GetSerializationFilters(), map,
-		pyjs::MarshallingOptions());
+	pyjs::MarshallingContext::Lease context(env);
+	Napi::Value napiValue = pyjs::Py_ConvertToJavascript(env, module, *context);
 
 	Py_XDECREF(module);
 
 	return napiValue;
 }
 
-static Napi::Value EvalHelper(const Napi::CallbackInfo &info, int type)
+//Converts each property of bindings straight into dict. False with an exception pending on failure.
+static bool BindVariables(const Napi::Env env, PyObject* dict, const Napi::Value bindings)
 {
-	Napi::Env env = info.Env();
+	if (!bindings.IsObject())
+		return true;
+
+	napi_value napi_keys;
+	uint32_t size = 0;
+	NAPI_DIRECT_START(env);
+	NAPI_DIRECT_FUNC(napi_get_property_names, bindings, &napi_keys);
+	NAPI_DIRECT_FUNC(napi_get_array_length, napi_keys, &size);
+
+	pyjs::MarshallingContext::Lease context(env);
+	for (uint32_t i = 0; i < size && !env.IsExceptionPending(); i++)
+	{
+		napi_value napi_key;
+		napi_value napi_val;
+		NAPI_DIRECT_FUNC(napi_get_element, napi_keys, i, &napi_key);
+		NAPI_DIRECT_FUNC(napi_get_property, bindings, napi_key, &napi_val);
+
+		PyObject* key = pyjs_utils::Js_StringToInternedKey(env, napi_key); //Js_StringToInternedKey (New)
+		if (key == NULL)
+		{
+			pyjs_utils::ThrowPythonException(env);
+			break;
+		}
+		PyObject* val = pyjs::Js_ConvertToPython(env, Napi::Value(env, napi_val), *context).first;
+		if (val == NULL || env.IsExceptionPending())
+		{
+			//Whatever was converted is released with the identity table.
+			Py_DECREF(key);
+			break;
+		}
+		if (PyDict_SetItem(dict, key, val) < 0) //PyDict_SetItem (Neutral)
+			pyjs_utils::ThrowPythonException(env);
+		Py_DECREF(key);
+		Py_DECREF(val);
+	}
 
+	return !env.IsExceptionPending();
+}
+
+//Runs code with the bindings bound as variables. With a namespace (a marshalled dict), the
+//code runs module-style with that dict as both globals and locals, so whatever it defines,
+//bindings included, persists for the next evaluation. Otherwise it runs against __main__'s
+//globals with fresh locals, so `global` statements still reach __main__. Nested scopes (lambdas,
+//comprehensions, functions) resolve free names as globals though, so when there are bindings
+//the code instead runs module-style in a throwaway copy of __main__'s namespace.
+static Napi::Value EvalCodeHelper(const Napi::Env env, PyObject* code, const Napi::Value bindings,
+	const Napi::Value ns)
+{
 	PY_CHECK_START()
 
-	PyObject* code = Py_CompileString( //Py_CompileString (New)
-		info[0].As<Napi::String>().Utf8Value().c_str(), 
-		info[1].As<Napi::String>().Utf8Value().c_str(), type);
-	PY_CHECK(env, code, NULL, env.Undefined());
+	PyObject* global;
+	PyObject* local;
+	NapiPyObject* npo = ns.IsUndefined() || ns.IsNull() ? nullptr : NapiPyObject::UnwrapMarshaled(env, ns);
+	if (npo != nullptr)
+	{
+		global = npo->GetPyObject(env);
+		if (!PyDict_Check(global))
+		{
+			NAPI_ERROR(env, "Invalid Parameters. A namespace must be a Python dict.");
+			return env.Undefined();
+		}
+		//Older versions only fall back to the real builtins when evaluating through exec().
+		if (PyDict_GetItemString(global, "__builtins__") == NULL && //PyDict_GetItemString (Borrowed)
+			PyDict_SetItemString(global, "__builtins__", PyEval_GetBuiltins()) < 0) //PyDict_SetItemString (Neutral)
+		{
+			pyjs_utils::ThrowPythonException(env);
+			return env.Undefined();
+		}
+
+		local = global;
+		Py_INCREF(local);
+	}
+	else if (!ns.IsUndefined() && !ns.IsNull())
+	{
+		NAPI_ERROR(env, "Invalid Parameters. A namespace must be a Python dict.");
+		return env.Undefined();
+	}
+	else
+	{
+		PyObject* main = PyImport_AddModule("__main__"); //PyImport_AddModule (Borrow)
+		PY_CHECK(env, main, NULL, env.Undefined());
 
-	PyObject* main = PyImport_AddModule("__main__"); //PyImport_AddModule (Borrow)
-	PY_CHECK(env, main, NULL, env.Undefined());
+		PyObject* main_dict = PyModule_GetDict(main); //PyModule_GetDict (Borrow)
+		PY_CHECK(env, main_dict, NULL, env.Undefined());
 
-	PyObject* global = PyModule_GetDict(main); //PyModule_GetDict (Borrow)
-	PY_CHECK(env, global, NULL, env.Undefined());
+		global = main_dict;
+		if (bindings.IsObject() && bindings.As<Napi::Object>().GetPropertyNames().Length() > 0)
+		{
+			//Carries __builtins__ along with whatever __main__ defines.
+			local = PyDict_Copy(main_dict); //PyDict_Copy (New)
+			PY_CHECK(env, local, NULL, env.Undefined());
+			global = local;
+		}
+		else
+		{
+			local = PyDict_New(); //PyDict_New (New)
+			PY_CHECK(env, local, NULL, env.Undefined());
+		}
+	}
+	PY_CHECK_INCLUDE(local);
 
-	PyObject* local = PyDict_New(); //PyDict_New (New)
-	PY_CHECK(env, local, NULL, env.Undefined());
+	if (!BindVariables(env, local, bindings))
+	{
+		PY_CHECK_NAPI_ERROR(env);
+		return env.Undefined();
+	}
 
 	PyObject* obj = PyEval_EvalCode(code, global, local); //PyEval_EvalCode (New)
 	PY_CHECK(env, obj, NULL, env.Undefined());
 
-	Py_XDECREF(code);
 	Py_XDECREF(local);
 
-	auto map = std::unique_ptr<std::unordered_map<PyObject*,napi_value>>
-		(new std::unordered_map<PyObject*,napi_value>());
-	auto res = pyjs::Py_ConvertToJavascript(env, obj,
-		pyjs::PyjsConfigurationOptions::GetSerializationFilters(), 
-		map, pyjs::MarshallingOptions());
+	pyjs::MarshallingContext::Lease context(env);
+	auto res = pyjs::Py_ConvertToJavascript(env, obj, *context);
 
 	Py_XDECREF(obj);
 
 	return res;
 }
 
+static Napi::Value EvalHelper(const Napi::CallbackInfo &info, int type)
+{
+	Napi::Env env = info.Env();
+
+	PY_CHECK_START()
+
+	PyObject* code = pyjs_utils::Py_CompileStringCached( //Py_CompileStringCached (New)
+		info[0].As<Napi::String>().Utf8Value(), 
+		info[1].As<Napi::String>().Utf8Value(), type);
+	PY_CHECK(env, code, NULL, env.Undefined());
+
+	//Use info[2] & info[3] for (bindings, namespace)
+	auto res = EvalCodeHelper(env, code, info[2], info[3]);
+
+	Py_XDECREF(code);
+
+	return res;
+}
+
 static Napi::Value Eval(const Napi::CallbackInfo &info)
 {
 	return EvalHelper(info, Py_eval_input);
@@ -792,6 +1337,50 @@ static Napi::Value EvalAsFile(const Napi::CallbackInfo &info)
 	return EvalHelper(info, Py_file_input);
 }
 
+//Compiles info[0] under the tag in info[1], as an expression unless info[2] is true,
+//and returns the code object as a raw PyObject for EvalCode.
+static Napi::Value Compile(const Napi::CallbackInfo &info)
+{
+	Napi::Env env = info.Env();
+
+	PY_CHECK_START()
+
+	int type = info[2].ToBoolean().Value() ? Py_file_input : Py_eval_input;
+	PyObject* code = pyjs_utils::Py_CompileStringCached( //Py_CompileStringCached (New)
+		info[0].As<Napi::String>().Utf8Value(), 
+		info[1].As<Napi::String>().Utf8Value(), type);
+	PY_CHECK(env, code, NULL, env.Undefined());
+
+	Napi::Value napiValue = NapiPyObject::NewInstance(env, {});
+	NapiPyObject* npo = Napi::ObjectWrap<NapiPyObject>::Unwrap(napiValue.As<Napi::Object>());
+	npo->SetPyObject(env, code); //NapiPyObject now managing memory for code
+	npo->SetObjectType(PyObjectType::Object);
+
+	return napiValue;
+}
+
+//Runs the code object from Compile (info[0]) with (bindings, namespace) in info[1] & info[2].
+static Napi::Value EvalCode(const Napi::CallbackInfo &info)
+{
+	Napi::Env env = info.Env();
+
+	if (!NapiPyObject::IsInstanceOfNative(env, info[0]))
+	{
+		NAPI_ERROR(env, "Invalid Parameters. Expecting a compiled code object.");
+		return env.Undefined();
+	}
+
+	NapiPyObject* npo = Napi::ObjectWrap<NapiPyObject>::Unwrap(info[0].As<Napi::Object>());
+	PyObject* code = npo->GetPyObject(env);
+	if (!PyCode_Check(code))
+	{
+		NAPI_ERROR(env, "Invalid Parameters. Expecting a compiled code object.");
+		return env.Undefined();
+	}
+
+	return EvalCodeHelper(env, code, info[1], info[2]);
+}
+
 static Napi::Value Global(const Napi::CallbackInfo &info)
 {
 	Napi::Env env = info.Env();
@@ -800,12 +1389,8 @@ static Napi::Value Global(const Napi::CallbackInfo &info)
 	if (__py__main__module_ == NULL)
 		return env.Undefined();
 
-	auto map = std::unique_ptr<std::unordered_map<PyObject*,napi_value>>
-		(new std::unordered_map<PyObject*,napi_value>());	
-
-	return pyjs::Py_ConvertToJavascript(env, __py__main__module_,
-		pyjs::PyjsConfigurationOptions::GetSerializationFilters(), 
-		map, pyjs::MarshallingOptions());	
+	pyjs::MarshallingContext::Lease context(env);
+	return pyjs::Py_ConvertToJavascript(env, __py__main__module_, *context);
 }
 
 Napi::Object InstanceInformation(const Napi::CallbackInfo &info)
@@ -873,12 +1458,9 @@ static PyObject* PyCapsuleNodeJSInterfaceFunctionCall(PyObject* self, PyObject*
 		auto future =
 			callback->call<PyObject*>([cb_args](Napi::Env env, std::vector<napi_value>& args)
 			{
-				auto map = std::unique_ptr<std::unordered_map<PyObject*,napi_value>>
-					(new std::unordered_map<PyObject*,napi_value>());
+				pyjs::MarshallingContext::Lease context(env);
 
-				auto js = pyjs::Py_ConvertToJavascript(env, cb_args,
-					pyjs::PyjsConfigurationOptions::GetSerializationFilters(),
-					map, pyjs::MarshallingOptions());
+				auto js = pyjs::Py_ConvertToJavascript(env, cb_args, *context);
 
 				Py_DECREF(cb_args); //We can get rid of args now.
 
@@ -888,10 +1470,9 @@ static PyObject* PyCapsuleNodeJSInterfaceFunctionCall(PyObject* self, PyObject*
 				Napi::Env env = napiValue.Env();
 				Napi::HandleScope scope(env);
 
-				const std::unique_ptr<const std::vector<Napi::Function>>&
-					serialization_filters = pyjs::PyjsConfigurationOptions::GetSerializationFilters();
+				pyjs::MarshallingContext::Lease context(env);
 				std::pair<PyObject*,PyObjectType> conv = pyjs::Js_ConvertToPython(env, napiValue,
-					serialization_filters);
+					*context);
 
 				return conv.first;
 			});
@@ -1029,6 +1610,8 @@ static PyObject* PyjsModuleInitAll(void)
 {
 	//Keep static reference
 	__pyjs_module_ = PyModule_Create(&PyCapsuleNodeJsModule); //PyModule_Create (New)
+	if (__pyjs_module_ != NULL && !pyjs_buffer::InitPythonTypes(__pyjs_module_))
+		Py_CLEAR(__pyjs_module_);
 
 	return __pyjs_module_;
 }
@@ -1056,6 +1639,8 @@ static Napi::Value Initialize(const Napi::CallbackInfo &info)
 		pyjs_utils::ThrowPythonException(env);
 	Py_INCREF(__py__main__module_); //Keep static reference.
 
+	pyjs_utils::InitDateTime();
+
 	PY_DEBUG("py.js initialized.");
 
 	return env.Undefined();
@@ -1067,6 +1652,9 @@ static Napi::Value BeginFinalize(const Napi::CallbackInfo &info)
 
 	PY_DEBUG("py.js says goodbye. finalize called.");
 	pyjs_async::DestroyAsyncHandlers();
+	pyjs_utils::ClearKeyCache();
+	pyjs_utils::ClearStringCache(env);
+	pyjs_utils::ClearCodeCache();
 	Py_XDECREF(__pyjs_module_);
 
 	return env.Undefined();
@@ -1104,11 +1692,17 @@ static Napi::Object InitAll(Napi::Env env, Napi::Object exports)
 	exports.Set("beginFinalize", Napi::Function::New(env, BeginFinalize));
 	exports.Set("eval", Napi::Function::New(env, Eval));
 	exports.Set("evalAsFile", Napi::Function::New(env, EvalAsFile));
+	exports.Set("$Compile", Napi::Function::New(env, Compile));
+	exports.Set("$EvalCode", Napi::Function::New(env, EvalCode));
 	exports.Set("global", Napi::Function::New(env, Global));
 	exports.Set("import", Napi::Function::New(env, Import));
 	exports.Set("instance", Napi::Function::New(env, InstanceInformation));
 	exports.Set("$GetMarshaledObject", Napi::Function::New(env, NapiPyObject::GetMarshaledObject));
 	exports.Set("$IsInstanceOf", Napi::Function::New(env, NapiPyObject::IsInstanceOf));
+	exports.Set("$TagMarshaledObject", Napi::Function::New(env, NapiPyObject::TagMarshaledObject));
+	exports.Set("$TagMethodReference", Napi::Function::New(env, NapiPyObject::TagMethodReference));
+	exports.Set("$ExecutePlan", Napi::Function::New(env, NapiPyObject::ExecutePlan));
+	InitNativeCollections(env);
 	NapiPyObject::Init(env, exports);
 	pyjs::PyjsConfigurationOptions::Init(env, exports);
 	pyjs_async::InitAll(env, exports);
@@ -84,27 +84,81 @@ enum PyObjectType
 	Unsupported
 };
 
-enum PyJsSpecialObjectType
-{
-	UnknownJSType = 0,
-	JSDateTime
-};
-
 namespace pyjs
 {
 	struct MarshallingOptions
 	{
-		MarshallingOptions() : rawReference(false) {}
-		MarshallingOptions(bool raw_reference) : rawReference(raw_reference) {}
+		MarshallingOptions() : rawReference(false), safeIntegerAsNumber(false),
+			zeroCopyBytes(false), typedArrays(false), numericArrays(false), dictAsObject(false),
+			recordsAsColumns(false) {}
+		MarshallingOptions(bool raw_reference) : rawReference(raw_reference), safeIntegerAsNumber(false),
+			zeroCopyBytes(false), typedArrays(false), numericArrays(false), dictAsObject(false),
+			recordsAsColumns(false) {}
 		bool rawReference;
+		//Python ints within +/-(2^53 - 1) become Numbers instead of BigInts.
+		bool safeIntegerAsNumber;
+		//Zero-copy for writable buffers: bytearray shares its memory with the Buffer (and can't be resized
+		//until the Buffer is collected); immutable bytes are always copied.
+		bool zeroCopyBytes;
+		//Numeric buffer exporters (e.g. numpy.ndarray) become TypedArrays.
+		bool typedArrays;
+		//Lists/tuples of only floats or only int32-range ints become Float64Array/Int32Array.
+		bool numericArrays;
+		//Dicts with only string keys become plain objects instead of Maps.
+		bool dictAsObject;
+		//(JS->Python) Arrays of objects sharing one key set become a dict of column lists.
+		bool recordsAsColumns;
+	};
+
+	//Tracks the JS objects already converted during one top-level Js_ConvertToPython call,
+	//so shared subtrees and cycles map back to the same PyObject.
+	class JsIdentityTable
+	{
+		public:
+			JsIdentityTable() : env_(NULL) {}
+			JsIdentityTable(const JsIdentityTable&) = delete;
+			JsIdentityTable& operator=(const JsIdentityTable&) = delete;
+			void Begin(napi_env env);
+			void Reset();
+			bool Find(napi_value val, PyObject** obj, PyObjectType* type);
+			void Register(napi_value val, PyObject* obj, PyObjectType type);
+		private:
+			napi_env env_;
+			std::vector<napi_value> wrapped_;
+			std::vector<std::pair<napi_value, PyObject*>> unwrappable_;
+			std::unordered_map<PyObject*, PyObjectType> objects_;
+	};
+
+	//State for one top-level conversion in either direction. Contexts are pooled and
+	//reset on release, so crossing the bridge doesn't allocate or call into JS for setup.
+	//Borrow one with MarshallingContext::Lease; nested conversions get their own.
+	class MarshallingContext
+	{
+		public:
+			class Lease
+			{
+				public:
+					Lease(const Napi::Env env, const MarshallingOptions& options = MarshallingOptions());
+					~Lease();
+					Lease(const Lease&) = delete;
+					Lease& operator=(const Lease&) = delete;
+					MarshallingContext& operator*() const { return *context_; }
+					MarshallingContext* operator->() const { return context_; }
+				private:
+					MarshallingContext* context_;
+			};
+
+			MarshallingOptions options;
+			JsIdentityTable identities;
+			std::unordered_map<PyObject*, napi_value> python_to_javascript;
+		private:
+			static std::vector<MarshallingContext*> pool_;
 	};
 
 	std::pair<PyObject*, PyObjectType> Js_ConvertToPython(const Napi::Env env,
-		const Napi::Value val, const std::unique_ptr<const std::vector<Napi::Function>> &filters);
+		const Napi::Value val, MarshallingContext& context);
 	Napi::Value Py_ConvertToJavascript(const Napi::Env env, PyObject* obj,
-		const std::unique_ptr<const std::vector<Napi::Function>> &filters,
-		std::unique_ptr<std::unordered_map<PyObject*,napi_value>>& python_to_javascript_map,
-		const MarshallingOptions& marshalling_options);
+		MarshallingContext& context);
 	Napi::Value Import(const Napi::CallbackInfo &info);
 
 	PyObject* FunctionBridgeRegisterCallback(const Napi::Env& env, Napi::Function f);
@@ -112,25 +166,29 @@ namespace pyjs
 	class PyjsConfigurationOptions
 	{
 		private:
-			static Napi::FunctionReference js_type_checking_callback_;
-			static Napi::FunctionReference serialization_filter_callback_;
-			static Napi::FunctionReference unmarshalling_filter_callback_;
 			static std::unique_ptr<napi_ext::ThreadSafeCallback> debug_messaging_callback_;
 
 		public:
 			static Napi::Object Init(const Napi::Env env, const Napi::Object exports);
-			static Napi::Value SetJSTypeCheckingCallback(const Napi::CallbackInfo &info);
-			static Napi::Value SetSerializationFiltersConstructor(const Napi::CallbackInfo &info);
-			static const std::unique_ptr<const std::vector<Napi::Function>> GetSerializationFilters();
-			static Napi::Value SetUnmarshallingFilter(const Napi::CallbackInfo &info);
-			static NapiPyObject* AttemptNapiObjectUnmarshalling(Napi::Env env, Napi::Value obj);
 			static Napi::Value SetDebugMessagingCallback(const Napi::CallbackInfo &info);
-			static PyJsSpecialObjectType CheckJSSpecialType(const Napi::Value val);
 			static void SendDebugMessage(const std::vector<std::string> msg);
 			static bool IsDebugEnabled();
 	};
 }
 
+namespace pyjs_buffer
+{
+	Napi::Value Py_BytesToExternalBuffer(const Napi::Env env, PyObject* obj);
+
+	bool InitPythonTypes(PyObject* module);
+	bool IsByteTypedArray(const Napi::Env env, const Napi::Value val);
+	PyObject* Js_TypedArrayToPythonView(const Napi::Env env, const Napi::Value val);
+	bool IsJsBufferView(PyObject* obj);
+	Napi::Value JsBufferViewToJavascript(const Napi::Env env, PyObject* obj);
+	bool Py_BufferToTypedArray(const Napi::Env env, PyObject* obj, Napi::Value& result);
+	bool Py_SequenceToTypedArray(const Napi::Env env, PyObject* obj, Napi::Value& result);
+}
+
 namespace pyjs_async
 {
 	struct python_loop {
@@ -151,6 +209,7 @@ namespace pyjs_async
 
 	void InitializeAsyncMessageSystem(const Napi::CallbackInfo &info);
 	void DestroyAsyncHandlers();
+	void ReleaseNodeReference(napi_env env, napi_ref ref);
 }
 
 //////////////////////////////////////////
@@ -184,6 +243,10 @@ class NapiPyObject : public Napi::ObjectWrap<NapiPyObject>
 		static Napi::Value GetMarshaledObject(const Napi::CallbackInfo &info);
 		static Napi::Value IsInstanceOf(const Napi::CallbackInfo &info);
 		static bool IsInstanceOfNative(Napi::Env env, Napi::Value val);
+		static NapiPyObject* UnwrapMarshaled(Napi::Env env, Napi::Value val);
+		static Napi::Value TagMarshaledObject(const Napi::CallbackInfo &info);
+		static Napi::Value TagMethodReference(const Napi::CallbackInfo &info);
+		static bool ResolveMethodReference(Napi::Env env, Napi::Value val, PyObject** obj);
 		Napi::Value GetObjectType(const Napi::CallbackInfo &info);
 		Napi::Value GetPythonTypeObject(const Napi::CallbackInfo &info);
 		Napi::Value GetAttributeList(const Napi::CallbackInfo &info);
@@ -191,9 +254,19 @@ class NapiPyObject : public Napi::ObjectWrap<NapiPyObject>
 		Napi::Value SetAttribute(const Napi::CallbackInfo &info);
 		Napi::Value IsCallable(const Napi::CallbackInfo &info);
 		static std::pair<PyObject*,PyObject*> ProcessFunctionCallArguments(const Napi::CallbackInfo &info);
+		static PyObject* CallWithArguments(const Napi::Env env, PyObject* callable,
+			const Napi::Value args, const Napi::Value kwargs, pyjs::MarshallingContext* context,
+			PyObject* method_name = NULL);
+		static Napi::Value MarshalReturnValue(const Napi::Env env, PyObject* ret,
+			const pyjs::MarshallingOptions& options);
 		static pyjs::MarshallingOptions ProcessMarshallingOptions(const Napi::Value val);
 		Napi::Value FunctionCallAsync(const Napi::CallbackInfo &info);
 		Napi::Value FunctionCall(const Napi::CallbackInfo &info);
+		Napi::Value FunctionCallRaw(const Napi::CallbackInfo &info);
+		Napi::Value FunctionCallBatch(const Napi::CallbackInfo &info);
+		static Napi::Value ExecutePlan(const Napi::CallbackInfo &info);
+		Napi::Value GetAttributeOrMethod(const Napi::CallbackInfo &info);
+		Napi::Value CallMethod(const Napi::CallbackInfo &info);
 		Napi::Value CloneReference(const Napi::CallbackInfo &info);
 		void SetPyObject(const Napi::Env env, PyObject* pyObject);
 		PyObject* GetPyObject(const Napi::Env env);
@@ -237,9 +310,38 @@ class lock_gil
 
 namespace pyjs_utils
 {
+	Napi::Value CreatePythonException(const Napi::Env env);
 	void ThrowPythonException(const Napi::Env env);
 	std::pair<std::string,PyObject*> GetPythonException();
 
+	napi_value Py_UnicodeToNapiString(const Napi::Env env, PyObject* obj);
+	PyObject* Js_StringToPyUnicode(const Napi::Env env, napi_value val);
+
+	struct CacheStats
+	{
+		size_t hits;
+		size_t misses;
+		size_t size;
+		size_t capacity;
+	};
+
+	PyObject* Js_StringToInternedKey(const Napi::Env env, napi_value val);
+	void ClearKeyCache();
+	CacheStats GetKeyCacheStats();
+
+	napi_value Py_UnicodeToCachedNapiString(const Napi::Env env, PyObject* obj);
+	void ClearStringCache(const Napi::Env env);
+	CacheStats GetStringCacheStats();
+
+	PyObject* Py_CompileStringCached(const std::string& source, const std::string& tag, int mode);
+	void ClearCodeCache();
+	CacheStats GetCodeCacheStats();
+
+	bool InitDateTime();
+	bool Py_IsDateTime(PyObject* obj);
+	PyObject* Js_DateToPyDateTime(const Napi::Env env, napi_value val);
+	napi_value Py_DateTimeToNapiDate(const Napi::Env env, PyObject* obj);
+
 	unsigned long GetCurrentTimeTicks();
 	std::string GetCurrentThreadID();
 
@@ -102,12 +102,9 @@ static void node_to_python_message_handler(uv_async_t* _handle)
 							//+ pyjs_utils::GetPythonException());
 					}
 
-					auto map = std::unique_ptr<std::unordered_map<PyObject*,napi_value>>
-						(new std::unordered_map<PyObject*,napi_value>());
+					pyjs::MarshallingContext::Lease context(env);
 
-					auto js = pyjs::Py_ConvertToJavascript(env, ret,
-						pyjs::PyjsConfigurationOptions::GetSerializationFilters(),
-						map, pyjs::MarshallingOptions());
+					auto js = pyjs::Py_ConvertToJavascript(env, ret, *context);
 
 					Py_DECREF(ret);
 
@@ -134,8 +131,45 @@ static void node_to_python_message_handler(uv_async_t* _handle)
 	}
 }
 
-//Does nothing for now.
-static void python_to_node_message_handler(uv_async_t* _handle) {}
+static std::thread::id _node_thread_id;
+static std::mutex _node_reference_queue_mutex;
+static std::vector<std::pair<napi_env, napi_ref>> node_reference_queue{};
+
+//Releases references dropped by Python on other threads; napi calls must happen on node's thread.
+static void python_to_node_message_handler(uv_async_t* _handle)
+{
+	std::vector<std::pair<napi_env, napi_ref>> _queue;
+
+	{
+		std::lock_guard<std::mutex> lock(_node_reference_queue_mutex);
+		_queue.swap(node_reference_queue);
+	}
+
+	for (const auto& ele : _queue)
+	{
+		napi_delete_reference(ele.first, ele.second);
+	}
+}
+
+void pyjs_async::ReleaseNodeReference(napi_env env, napi_ref ref)
+{
+	if (std::this_thread::get_id() == _node_thread_id)
+	{
+		napi_delete_reference(env, ref);
+		return;
+	}
+
+	//Node is shutting down; the environment cleans up its own references.
+	if (exiting)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(_node_reference_queue_mutex);
+		node_reference_queue.emplace_back(env, ref);
+	}
+
+	uv_async_send(&py_loop.ptn_async_handler);
+}
 
 static void python_loop_thread(pyjs_async::python_loop* _py_loop)
 {
@@ -162,6 +196,7 @@ void pyjs_async::StartMainPythonLoop(const Napi::CallbackInfo &info)
 	Napi::Env env = info.Env();
 	NAPI_DIRECT_START(env);
 	NAPI_DIRECT_FUNC(napi_get_uv_event_loop, &_node_event_loop);
+	_node_thread_id = std::this_thread::get_id();
 
 	UV_CHECK_START();
 
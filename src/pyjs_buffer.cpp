@@ -0,0 +1,443 @@
+//////////////////////////////////////////////////////////////////////////
+//	py.js - Node.js/Python Bridge; Node.js-hosted Python.
+//	Copyright (C) 2019  Michael Brown
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as
+//	published by the Free Software Foundation, either version 3 of the
+//	License, or (at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//	Additional permission under the GNU Affero GPL version 3 section 7:
+//
+//	If you modify this Program, or any covered work, by linking or
+//	combining it with other code, such other code is not for that reason
+//	alone subject to any of the requirements of the GNU Affero GPL
+//	version 3.
+//////////////////////////////////////////////////////////////////////////
+
+#include "pyjs_.h"
+
+////////////////////////////////////////////
+// Python -> Javascript (Zero-Copy Buffers)
+////////////////////////////////////////////
+
+//Small payloads are cheaper to copy than to track with a finalizer.
+static const Py_ssize_t ZERO_COPY_MIN_SIZE = 1024;
+
+//Owns the Python buffer export for as long as V8 holds the external memory.
+struct PyBufferExport
+{
+	Py_buffer view;
+};
+
+static void FinalizePyBufferExport(napi_env env, void* data, void* hint)
+{
+	PyBufferExport* buffer_export = static_cast<PyBufferExport*>(hint);
+
+	//V8 may collect after Python has been torn down, in which case there's nothing to release.
+	if (Py_IsInitialized())
+	{
+		lock_gil lock_me;
+		PyBuffer_Release(&buffer_export->view); //Drops the reference held by the export.
+	}
+
+	delete buffer_export;
+}
+
+Napi::Value pyjs_buffer::Py_BytesToExternalBuffer(const Napi::Env env, PyObject* obj)
+{
+	PyBufferExport* buffer_export = new PyBufferExport();
+
+	//Exporting a bytearray also locks it against resizing until the export is released.
+	if (PyObject_GetBuffer(obj, &buffer_export->view, PyBUF_SIMPLE) < 0)
+	{
+		delete buffer_export;
+		pyjs_utils::ThrowPythonException(env);
+		return env.Undefined();
+	}
+
+	Py_buffer& view = buffer_export->view;
+	napi_value napi_buffer = NULL;
+	napi_status status = napi_generic_failure;
+
+	//JS can write through a Buffer, so only writable exports are shared; read-only ones are copied.
+	if (view.len >= ZERO_COPY_MIN_SIZE && !view.readonly)
+	{
+		status = napi_create_external_buffer(env, view.len, view.buf,
+			FinalizePyBufferExport, buffer_export, &napi_buffer);
+	}
+
+	//Small or read-only buffers, or runtimes that refuse external memory, get a copy instead.
+	if (status != napi_ok)
+	{
+		Napi::Value copy = Napi::Buffer<char>::Copy(env, static_cast<char*>(view.buf), view.len);
+		PyBuffer_Release(&view);
+		delete buffer_export;
+		return copy;
+	}
+
+	return Napi::Value(env, napi_buffer);
+}
+
+////////////////////////////////////////////
+// Javascript -> Python (TypedArray Views)
+////////////////////////////////////////////
+
+//A Python object exporting the memory of a JS TypedArray through the buffer protocol.
+//The TypedArray is pinned with a napi_ref for as long as the view is alive.
+//Note: detaching the underlying ArrayBuffer (e.g. transferring it) invalidates the view.
+struct PyJsBufferView
+{
+	PyObject_HEAD
+	napi_env env;
+	napi_ref ref;
+	void* data;
+	Py_ssize_t length;
+	Py_ssize_t itemsize;
+	const char* format;
+};
+
+static PyTypeObject* JsBufferViewType = NULL;
+
+static int JsBufferViewGetBuffer(PyObject* self, Py_buffer* view, int flags)
+{
+	PyJsBufferView* bv = reinterpret_cast<PyJsBufferView*>(self);
+
+	view->buf = bv->data;
+	view->obj = self;
+	Py_INCREF(self); //Released by PyBuffer_Release.
+	view->len = bv->length * bv->itemsize;
+	view->readonly = 0;
+	view->itemsize = bv->itemsize;
+	view->format = (flags & PyBUF_FORMAT) == PyBUF_FORMAT ? const_cast<char*>(bv->format) : NULL;
+	view->ndim = 1;
+	view->shape = (flags & PyBUF_ND) == PyBUF_ND ? &bv->length : NULL;
+	view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? &bv->itemsize : NULL;
+	view->suboffsets = NULL;
+	view->internal = NULL;
+
+	return 0;
+}
+
+static void JsBufferViewDealloc(PyObject* self)
+{
+	PyJsBufferView* bv = reinterpret_cast<PyJsBufferView*>(self);
+	PyTypeObject* type = Py_TYPE(self);
+
+	if (bv->ref != NULL)
+		pyjs_async::ReleaseNodeReference(bv->env, bv->ref);
+
+	type->tp_free(self);
+	Py_DECREF(type); //Heap type instances own a reference to their type.
+}
+
+static PyType_Slot JsBufferViewSlots[] =
+{
+	{ Py_tp_dealloc, reinterpret_cast<void*>(JsBufferViewDealloc) },
+	{ Py_bf_getbuffer, reinterpret_cast<void*>(JsBufferViewGetBuffer) },
+	{ Py_tp_doc, const_cast<char*>("memory of a node.js TypedArray, exported through the buffer protocol.") },
+	{ 0, NULL }
+};
+
+static PyType_Spec JsBufferViewSpec =
+{
+	"__pyjs.JsBufferView",
+	sizeof(PyJsBufferView),
+	0,
+#ifdef Py_TPFLAGS_DISALLOW_INSTANTIATION
+	Py_TPFLAGS_DEFAULT | Py_TPFLAGS_DISALLOW_INSTANTIATION,
+#else
+	Py_TPFLAGS_DEFAULT,
+#endif
+	JsBufferViewSlots
+};
+
+//Buffer protocol format and item size for each TypedArray kind.
+static bool TypedArrayFormat(napi_typedarray_type type, const char** format, Py_ssize_t* itemsize)
+{
+	switch (type)
+	{
+		case napi_int8_array: *format = "b"; *itemsize = 1; return true;
+		case napi_uint8_array: *format = "B"; *itemsize = 1; return true;
+		case napi_uint8_clamped_array: *format = "B"; *itemsize = 1; return true;
+		case napi_int16_array: *format = "h"; *itemsize = 2; return true;
+		case napi_uint16_array: *format = "H"; *itemsize = 2; return true;
+		case napi_int32_array: *format = "i"; *itemsize = 4; return true;
+		case napi_uint32_array: *format = "I"; *itemsize = 4; return true;
+		case napi_float32_array: *format = "f"; *itemsize = 4; return true;
+		case napi_float64_array: *format = "d"; *itemsize = 8; return true;
+		case napi_bigint64_array: *format = "q"; *itemsize = 8; return true;
+		case napi_biguint64_array: *format = "Q"; *itemsize = 8; return true;
+		default: return false;
+	}
+}
+
+bool pyjs_buffer::InitPythonTypes(PyObject* module)
+{
+	JsBufferViewType = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&JsBufferViewSpec)); //PyType_FromSpec (New)
+	if (JsBufferViewType == NULL)
+		return false;
+
+	//Keep static reference; PyModule_AddObject steals the second one on success.
+	Py_INCREF(JsBufferViewType);
+	if (PyModule_AddObject(module, "JsBufferView", reinterpret_cast<PyObject*>(JsBufferViewType)) < 0)
+	{
+		Py_DECREF(JsBufferViewType);
+		return false;
+	}
+
+	return true;
+}
+
+bool pyjs_buffer::IsByteTypedArray(const Napi::Env env, const Napi::Value val)
+{
+	napi_typedarray_type type;
+	if (napi_get_typedarray_info(env, val, &type, NULL, NULL, NULL, NULL) != napi_ok)
+		return true;
+
+	//Node.js Buffers are Uint8Arrays, which keep marshalling as bytes.
+	return type == napi_uint8_array;
+}
+
+PyObject* pyjs_buffer::Js_TypedArrayToPythonView(const Napi::Env env, const Napi::Value val)
+{
+	napi_typedarray_type type;
+	size_t length;
+	void* data;
+	if (napi_get_typedarray_info(env, val, &type, &length, &data, NULL, NULL) != napi_ok)
+	{
+		PyErr_SetString(PyExc_TypeError, "Expected a TypedArray.");
+		return NULL;
+	}
+
+	const char* format;
+	Py_ssize_t itemsize;
+	if (!TypedArrayFormat(type, &format, &itemsize))
+	{
+		PyErr_SetString(PyExc_TypeError, "Unsupported TypedArray type.");
+		return NULL;
+	}
+
+	PyJsBufferView* bv = reinterpret_cast<PyJsBufferView*>(
+		JsBufferViewType->tp_alloc(JsBufferViewType, 0)); //tp_alloc (New)
+	if (bv == NULL)
+		return NULL;
+
+	bv->env = env;
+	bv->data = data;
+	bv->length = static_cast<Py_ssize_t>(length);
+	bv->itemsize = itemsize;
+	bv->format = format;
+
+	if (napi_create_reference(env, val, 1, &bv->ref) != napi_ok)
+	{
+		bv->ref = NULL;
+		Py_DECREF(bv);
+		PyErr_SetString(PyExc_RuntimeError, "Unable to pin TypedArray.");
+		return NULL;
+	}
+
+	return reinterpret_cast<PyObject*>(bv);
+}
+
+bool pyjs_buffer::IsJsBufferView(PyObject* obj)
+{
+	return JsBufferViewType != NULL && Py_TYPE(obj) == JsBufferViewType;
+}
+
+Napi::Value pyjs_buffer::JsBufferViewToJavascript(const Napi::Env env, PyObject* obj)
+{
+	//Hand back the original TypedArray.
+	PyJsBufferView* bv = reinterpret_cast<PyJsBufferView*>(obj);
+	napi_value napi_typedarray;
+
+	NAPI_DIRECT_START(env);
+	NAPI_DIRECT_FUNC(napi_get_reference_value, bv->ref, &napi_typedarray);
+
+	return Napi::Value(env, napi_typedarray);
+}
+
+////////////////////////////////////////////
+// Python -> Javascript (TypedArrays)
+////////////////////////////////////////////
+
+//Maps a single-item struct format to the TypedArray with the same layout.
+static bool TypedArrayTypeFromFormat(const char* format, Py_ssize_t itemsize, napi_typedarray_type* type)
+{
+	if (format == NULL)
+		format = "B";
+
+	//Native or standard little-endian order only; V8 uses the host's byte order.
+	if (*format == '@' || *format == '=' || (*format == '<' && PY_LITTLE_ENDIAN))
+		format++;
+
+	if (format[0] == '\0' || format[1] != '\0')
+		return false;
+
+	bool is_signed;
+	switch (format[0])
+	{
+		case 'f': *type = napi_float32_array; return itemsize == 4;
+		case 'd': *type = napi_float64_array; return itemsize == 8;
+		case 'b': case 'h': case 'i': case 'l': case 'q': is_signed = true; break;
+		case 'B': case 'H': case 'I': case 'L': case 'Q': is_signed = false; break;
+		default: return false;
+	}
+
+	//Integer formats are sized by the exporter ('l' differs between platforms).
+	switch (itemsize)
+	{
+		case 1: *type = is_signed ? napi_int8_array : napi_uint8_array; return true;
+		case 2: *type = is_signed ? napi_int16_array : napi_uint16_array; return true;
+		case 4: *type = is_signed ? napi_int32_array : napi_uint32_array; return true;
+		case 8: *type = is_signed ? napi_bigint64_array : napi_biguint64_array; return true;
+		default: return false;
+	}
+}
+
+bool pyjs_buffer::Py_BufferToTypedArray(const Napi::Env env, PyObject* obj, Napi::Value& result)
+{
+	if (!PyObject_CheckBuffer(obj))
+		return false;
+
+	PyBufferExport* buffer_export = new PyBufferExport();
+	Py_buffer& view = buffer_export->view;
+
+	//Only C-contiguous exports can be addressed as a flat TypedArray.
+	if (PyObject_GetBuffer(obj, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0)
+	{
+		PyErr_Clear();
+		delete buffer_export;
+		return false;
+	}
+
+	//A TypedArray has no shape, so only one-dimensional exports are converted. Anything else
+	//stays a proxy rather than silently coming back flattened.
+	napi_typedarray_type type;
+	if (view.ndim != 1 || !TypedArrayTypeFromFormat(view.format, view.itemsize, &type))
+	{
+		PyBuffer_Release(&view);
+		delete buffer_export;
+		return false;
+	}
+
+	size_t byte_length = static_cast<size_t>(view.len);
+	size_t length = byte_length / static_cast<size_t>(view.itemsize);
+	napi_value napi_arraybuffer = NULL;
+	napi_status status = napi_generic_failure;
+
+	//Share writable, aligned memory; read-only exports (e.g. arrays over bytes) are copied.
+	if (!view.readonly && byte_length > 0 &&
+		reinterpret_cast<uintptr_t>(view.buf) % static_cast<uintptr_t>(view.itemsize) == 0)
+	{
+		status = napi_create_external_arraybuffer(env, view.buf, byte_length,
+			FinalizePyBufferExport, buffer_export, &napi_arraybuffer);
+	}
+
+	if (status != napi_ok)
+	{
+		void* data = NULL;
+		status = napi_create_arraybuffer(env, byte_length, &data, &napi_arraybuffer);
+		if (status == napi_ok && byte_length > 0)
+			memcpy(data, view.buf, byte_length);
+
+		PyBuffer_Release(&view);
+		delete buffer_export;
+
+		if (status != napi_ok)
+		{
+			NAPI_ERROR(env, "Unable to allocate ArrayBuffer.");
+			result = env.Undefined();
+			return true;
+		}
+	}
+
+	napi_value napi_typedarray;
+	NAPI_DIRECT_START(env);
+	NAPI_DIRECT_FUNC(napi_create_typedarray, type, length, napi_arraybuffer, 0, &napi_typedarray);
+
+	result = Napi::Value(env, napi_typedarray);
+	return true;
+}
+
+////////////////////////////////////////////
+// Python -> Javascript (Numeric Sequences)
+////////////////////////////////////////////
+
+bool pyjs_buffer::Py_SequenceToTypedArray(const Napi::Env env, PyObject* obj, Napi::Value& result)
+{
+	//Lists and tuples only; both expose their items as a contiguous array.
+	Py_ssize_t size = PySequence_Fast_GET_SIZE(obj);
+	PyObject** items = PySequence_Fast_ITEMS(obj); //PySequence_Fast_ITEMS (Borrowed)
+
+	if (size < 1)
+		return false;
+
+	//Scan: every element must be an exact float, or an exact int within int32 range.
+	napi_typedarray_type type;
+	if (PyFloat_CheckExact(items[0]))
+	{
+		type = napi_float64_array;
+		for (Py_ssize_t i = 1; i < size; i++)
+			if (!PyFloat_CheckExact(items[i]))
+				return false;
+	}
+	else if (PyLong_CheckExact(items[0]))
+	{
+		type = napi_int32_array;
+		for (Py_ssize_t i = 0; i < size; i++)
+		{
+			if (!PyLong_CheckExact(items[i]))
+				return false;
+
+			int overflow;
+			long long value = PyLong_AsLongLongAndOverflow(items[i], &overflow);
+			if (overflow != 0 || value < INT32_MIN || value > INT32_MAX)
+				return false;
+		}
+	}
+	else
+	{
+		return false;
+	}
+
+	//Fill: write straight into the ArrayBuffer's backing store.
+	void* data;
+	napi_value napi_arraybuffer;
+	napi_value napi_typedarray;
+	size_t itemsize = type == napi_float64_array ? sizeof(double) : sizeof(int32_t);
+
+	NAPI_DIRECT_START(env);
+	NAPI_DIRECT_FUNC(napi_create_arraybuffer, static_cast<size_t>(size) * itemsize, &data, &napi_arraybuffer);
+	if (_napi_status != napi_ok)
+	{
+		result = env.Undefined();
+		return true;
+	}
+
+	if (type == napi_float64_array)
+	{
+		double* values = static_cast<double*>(data);
+		for (Py_ssize_t i = 0; i < size; i++)
+			values[i] = PyFloat_AS_DOUBLE(items[i]);
+	}
+	else
+	{
+		int32_t* values = static_cast<int32_t*>(data);
+		for (Py_ssize_t i = 0; i < size; i++)
+			values[i] = static_cast<int32_t>(PyLong_AsLong(items[i]));
+	}
+
+	NAPI_DIRECT_FUNC(napi_create_typedarray, type, static_cast<size_t>(size), napi_arraybuffer, 0, &napi_typedarray);
+
+	result = Napi::Value(env, napi_typedarray);
+	return true;
+}
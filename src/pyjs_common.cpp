@@ -81,17 +81,61 @@ inline Napi::Value CoerceAsTuple(const Napi::CallbackInfo &info)
 	return scope.Escape(napi_value(napiValue));
 }
 
+inline Napi::Value CoerceAsView(const Napi::CallbackInfo &info)
+{
+	Napi::Env env = info.Env();
+
+	PyObject* obj = pyjs_buffer::Js_TypedArrayToPythonView(env, info[0]); //Js_TypedArrayToPythonView (New)
+	if (obj == NULL)
+	{
+		pyjs_utils::ThrowPythonException(env);
+		return env.Undefined();
+	}
+
+	Napi::Value napiValue = NapiPyObject::NewInstance(env, {});
+	NapiPyObject* npo = Napi::ObjectWrap<NapiPyObject>::Unwrap(napiValue.As<Napi::Object>());
+	npo->SetPyObject(env, obj);
+	npo->SetObjectType(PyObjectType::Object);
+
+	return napiValue;
+}
+
 inline Napi::Object coerceAs(Napi::Env env)
 {
 	Napi::Object obj = Napi::Object::New(env);
 	obj.Set("Integer", Napi::Function::New(env, CoerceAsInteger));
 	obj.Set("Tuple", Napi::Function::New(env, CoerceAsTuple));
+	obj.Set("View", Napi::Function::New(env, CoerceAsView));
 
 	return obj;
 };
 
+inline Napi::Object CacheStatsObject(Napi::Env env, const pyjs_utils::CacheStats& stats)
+{
+	Napi::Object obj = Napi::Object::New(env);
+	obj.Set("hits", Napi::Number::New(env, static_cast<double>(stats.hits)));
+	obj.Set("misses", Napi::Number::New(env, static_cast<double>(stats.misses)));
+	obj.Set("size", Napi::Number::New(env, static_cast<double>(stats.size)));
+	obj.Set("capacity", Napi::Number::New(env, static_cast<double>(stats.capacity)));
+
+	return obj;
+}
+
+inline Napi::Value GetStats(const Napi::CallbackInfo &info)
+{
+	Napi::Env env = info.Env();
+
+	Napi::Object obj = Napi::Object::New(env);
+	obj.Set("keyCache", CacheStatsObject(env, pyjs_utils::GetKeyCacheStats()));
+	obj.Set("stringCache", CacheStatsObject(env, pyjs_utils::GetStringCacheStats()));
+	obj.Set("codeCache", CacheStatsObject(env, pyjs_utils::GetCodeCacheStats()));
+
+	return obj;
+}
+
 Napi::Object pyjs_utils::InitAll(Napi::Env env, Napi::Object exports)
 {
 	exports.Set("$coerceAs", coerceAs(env));
+	exports.Set("$GetStats", Napi::Function::New(env, GetStats));
 	return exports;
 }
\ No newline at end of file
@@ -50,6 +50,18 @@ NapiPyObjectContainer::~NapiPyObjectContainer()
 Napi::FunctionReference NapiPyObject::constructor_;
 Napi::FunctionReference NapiPyObject::serialization_callback_;
 
+//Type tags let native code recognise wrappers and marshalling proxies without calling into JS.
+static const napi_type_tag napi_pyobject_tag_ = { 0x7079a5f0c1d24e6bULL, 0x9b3e51a0d84f2c17ULL };
+static const napi_type_tag marshaled_proxy_tag_ = { 0x7079a5f0c1d24e6bULL, 0x4c8d17e2a95b30f6ULL };
+static const napi_type_tag method_reference_tag_ = { 0x7079a5f0c1d24e6bULL, 0xe26a0f9d3b7c5184ULL };
+
+//What a method thunk stands for: owner.name, resolved only if the thunk itself is passed to Python.
+struct MethodReference
+{
+	PyObject* owner;
+	PyObject* name;
+};
+
 void NapiPyObject::SetSerializationCallBackConstructor(const Napi::CallbackInfo &info)
 {
 	serialization_callback_.Reset();
@@ -70,6 +82,10 @@ Napi::Object NapiPyObject::Init(Napi::Env env, Napi::Object exports)
 		NapiPyObject::InstanceMethod("IsCallable", &NapiPyObject::IsCallable),
 		NapiPyObject::InstanceMethod("FunctionCallAsync", &NapiPyObject::FunctionCallAsync),
 		NapiPyObject::InstanceMethod("FunctionCall", &NapiPyObject::FunctionCall),
+		NapiPyObject::InstanceMethod("FunctionCallRaw", &NapiPyObject::FunctionCallRaw),
+		NapiPyObject::InstanceMethod("FunctionCallBatch", &NapiPyObject::FunctionCallBatch),
+		NapiPyObject::InstanceMethod("GetAttributeOrMethod", &NapiPyObject::GetAttributeOrMethod),
+		NapiPyObject::InstanceMethod("CallMethod", &NapiPyObject::CallMethod),
 		NapiPyObject::InstanceMethod("CloneReference", &NapiPyObject::CloneReference)
 	});
 
@@ -95,11 +111,8 @@ Napi::Value NapiPyObject::GetPythonTypeObject(const Napi::CallbackInfo &info)
 	PyObject* itm = this->container_->get_pyObject();
 	PyObject* type = PyObject_Type(itm);
 	
-	auto map = std::unique_ptr<std::unordered_map<PyObject*,napi_value>>
-		(new std::unordered_map<PyObject*,napi_value>());
-	auto res = pyjs::Py_ConvertToJavascript(env, type,
-		pyjs::PyjsConfigurationOptions::GetSerializationFilters(),
-		map, pyjs::MarshallingOptions());
+	pyjs::MarshallingContext::Lease context(env);
+	auto res = pyjs::Py_ConvertToJavascript(env, type, *context);
 
 	Py_XDECREF(type);
 
@@ -149,8 +162,8 @@ Napi::Value NapiPyObject::GetAttributeList(const Napi::CallbackInfo &info)
 	{
 		PyObject* name = PyList_GetItem(dir, i); //PyList_GetItem (Borrowed)
 		PY_CHECK(env, name, NULL, env.Undefined());
-		napi_value napi_name;
-		NAPI_DIRECT_FUNC(napi_create_string_utf8, PyUnicode_AsUTF8(name), NAPI_AUTO_LENGTH, &napi_name);
+		napi_value napi_name = pyjs_utils::Py_UnicodeToCachedNapiString(env, name);
+		PY_CHECK(env, napi_name, NULL, env.Undefined());
 		NAPI_DIRECT_FUNC(napi_set_element, napi_array, i, napi_name);
 	}
 
@@ -167,17 +180,19 @@ Napi::Value NapiPyObject::GetAttribute(const Napi::CallbackInfo &info)
 	Napi::Env env = info.Env();
 
 	PyObject* pyObject = this->container_->get_pyObject();
-	PyObject* attr_name = PyUnicode_FromString(info[0].ToString().Utf8Value().c_str()); //PyUnicode_FromString (New)
+	PyObject* attr_name = pyjs_utils::Js_StringToInternedKey(env, info[0].ToString()); //Js_StringToInternedKey (New)
+	if (attr_name == NULL)
+	{
+		pyjs_utils::ThrowPythonException(env);
+		return env.Undefined();
+	}
+
 	PyObject* attr = PyObject_GetAttr(pyObject, attr_name); //PyObject_GetItem (New)
 	Py_XDECREF(attr_name);
 
-	auto map = std::unique_ptr<std::unordered_map<PyObject*,napi_value>>
-		(new std::unordered_map<PyObject*,napi_value>());
-	
 	//Use info[1] for marshalling options
-	auto res = pyjs::Py_ConvertToJavascript(env, attr,
-		pyjs::PyjsConfigurationOptions::GetSerializationFilters(),
-		map, NapiPyObject::ProcessMarshallingOptions(info[1]));
+	pyjs::MarshallingContext::Lease context(env, NapiPyObject::ProcessMarshallingOptions(info[1]));
+	auto res = pyjs::Py_ConvertToJavascript(env, attr, *context);
 	
 	Py_XDECREF(attr);
 
@@ -194,8 +209,13 @@ Napi::Value NapiPyObject::SetAttribute(const Napi::CallbackInfo &info)
 	PyObject* itm = npo->GetPyObject(env);
 	Py_INCREF(itm); // NapiPyObject(Future Delete)
 
-	if (PyObject_SetAttrString(pyObject, info[0].ToString().Utf8Value().c_str(), itm) < 0)
+	PyObject* attr_name = pyjs_utils::Js_StringToInternedKey(env, info[0].ToString()); //Js_StringToInternedKey (New)
+	if (attr_name == NULL || PyObject_SetAttr(pyObject, attr_name, itm) < 0)
+	{
+		PyErr_Clear();
 		NAPI_ERROR(env, "Error setting attribute '" + info[0].ToString().Utf8Value() + "' on object.");
+	}
+	Py_XDECREF(attr_name);
 
 	return env.Undefined();
 }
@@ -266,7 +286,7 @@ std::pair<PyObject*,PyObject*> NapiPyObject::ProcessFunctionCallArguments(const
 
 			NapiPyObject* npo = Napi::ObjectWrap<NapiPyObject>::Unwrap(ele_val.As<Napi::Object>());
 
-			PyObject* key_1 = PyUnicode_FromString(ele_key.As<Napi::String>().Utf8Value().c_str()); //PyUnicode_FromString (New)
+			PyObject* key_1 = pyjs_utils::Js_StringToInternedKey(env, ele_key); //Js_StringToInternedKey (New)
 			PyObject* val_2 = npo->GetPyObject(env);
 
 			PyDict_SetItem(dict, key_1, val_2); //PyDict_SetItem (Neutral)
@@ -277,9 +297,168 @@ std::pair<PyObject*,PyObject*> NapiPyObject::ProcessFunctionCallArguments(const
 	return std::make_pair(args, dict);
 }
 
+//Stack space for typical arities (plus the self slot and the slot vectorcall may borrow);
+//larger calls spill to the heap.
+static const size_t SMALL_CALL_ARITY = 8;
+
+//Calls callable(*items[:nargs], **dict(zip(kwnames, items[nargs:]))). items[-1] must be writable,
+//as vectorcall may borrow it for the duration of the call.
+static PyObject* CallVector(PyObject* callable, PyObject** items, size_t nargs, PyObject* kwnames)
+{
+#if PY_VERSION_HEX >= 0x03090000
+	return PyObject_Vectorcall(callable, items, 
+		nargs | PY_VECTORCALL_ARGUMENTS_OFFSET, kwnames); //PyObject_Vectorcall (New)
+#else
+	Py_ssize_t nkwargs = kwnames != NULL ? PyTuple_GET_SIZE(kwnames) : 0;
+	PyObject* ret = NULL;
+	PyObject* tuple = PyTuple_New(nargs); //PyTuple_New (New)
+	PyObject* dict = kwnames != NULL ? PyDict_New() : NULL; //PyDict_New (New)
+	if (tuple != NULL && (kwnames == NULL || dict != NULL))
+	{
+		for (size_t i = 0; i < nargs; i++)
+		{
+			Py_INCREF(items[i]);
+			PyTuple_SET_ITEM(tuple, i, items[i]); //PyTuple_SET_ITEM (Steals)
+		}
+		for (Py_ssize_t i = 0; i < nkwargs; i++)
+			PyDict_SetItem(dict, PyTuple_GET_ITEM(kwnames, i), items[nargs + i]); //PyDict_SetItem (Neutral)
+
+		ret = PyObject_Call(callable, tuple, dict); //PyObject_Call (New)
+	}
+	Py_XDECREF(tuple);
+	Py_XDECREF(dict);
+	return ret;
+#endif
+}
+
+//With a context, args/kwargs hold raw JS values converted here, owned until the call returns.
+//Without one they hold NapiPyObjects and are borrowed; the JS argument array keeps every wrapper,
+//and so every PyObject, alive for the duration of the call.
+//With a method_name, callable is the receiver and callable.method_name(...) is called instead.
+PyObject* NapiPyObject::CallWithArguments(const Napi::Env env, PyObject* callable,
+	const Napi::Value args, const Napi::Value kwargs, pyjs::MarshallingContext* context,
+	PyObject* method_name)
+{
+	napi_value napi_arr = args;
+	napi_value napi_keys = NULL;
+	uint32_t nargs = 0;
+	uint32_t nkwargs = 0;
+
+	NAPI_DIRECT_START(env);
+	NAPI_DIRECT_FUNC(napi_get_array_length, napi_arr, &nargs);
+	if (!kwargs.IsUndefined() && !kwargs.IsNull())
+	{
+		NAPI_DIRECT_FUNC(napi_get_property_names, kwargs, &napi_keys);
+		NAPI_DIRECT_FUNC(napi_get_array_length, napi_keys, &nkwargs);
+	}
+	if (env.IsExceptionPending())
+		return NULL;
+
+	size_t total = static_cast<size_t>(nargs) + nkwargs;
+	PyObject* small[SMALL_CALL_ARITY + 2];
+	std::vector<PyObject*> large;
+	PyObject** stack = small;
+	if (total > SMALL_CALL_ARITY)
+	{
+		large.resize(total + 2);
+		stack = large.data();
+	}
+	PyObject** items = stack + 2;
+	size_t filled = 0;
+
+	auto argument = [&](napi_value napi_val) -> PyObject*
+	{
+		if (context != nullptr)
+			return pyjs::Js_ConvertToPython(env, Napi::Value(env, napi_val), *context).first;
+		return Napi::ObjectWrap<NapiPyObject>::Unwrap(Napi::Object(env, napi_val))->GetPyObject(env);
+	};
+
+	for (uint32_t i = 0; i < nargs && !env.IsExceptionPending(); i++)
+	{
+		napi_value napi_ele;
+		NAPI_DIRECT_FUNC(napi_get_element, napi_arr, i, &napi_ele);
+		items[filled] = argument(napi_ele);
+		filled++;
+	}
+
+	PyObject* kwnames = NULL;
+	if (nkwargs > 0 && !env.IsExceptionPending())
+	{
+		kwnames = PyTuple_New(nkwargs); //PyTuple_New (New)
+
+		for (uint32_t i = 0; kwnames != NULL && i < nkwargs && !env.IsExceptionPending(); i++)
+		{
+			napi_value napi_key;
+			napi_value napi_val;
+			NAPI_DIRECT_FUNC(napi_get_element, napi_keys, i, &napi_key);
+			NAPI_DIRECT_FUNC(napi_get_property, kwargs, napi_key, &napi_val);
+
+			PyObject* key = pyjs_utils::Js_StringToInternedKey(env, napi_key); //Js_StringToInternedKey (New)
+			if (key == NULL)
+			{
+				Py_CLEAR(kwnames);
+				break;
+			}
+			PyTuple_SET_ITEM(kwnames, i, key); //PyTuple_SET_ITEM (Steals)
+			items[filled] = argument(napi_val);
+			filled++;
+		}
+	}
+
+	PyObject* ret = NULL;
+	if (!env.IsExceptionPending() && !PyErr_Occurred())
+	{
+		if (method_name != NULL)
+		{
+#if PY_VERSION_HEX >= 0x03090000
+			items[-1] = callable;
+			ret = PyObject_VectorcallMethod(method_name, items - 1,
+				(nargs + 1) | PY_VECTORCALL_ARGUMENTS_OFFSET, kwnames); //PyObject_VectorcallMethod (New)
+#else
+			PyObject* method = PyObject_GetAttr(callable, method_name); //PyObject_GetAttr (New)
+			if (method != NULL)
+				ret = CallVector(method, items, nargs, kwnames); //CallVector (New)
+			Py_XDECREF(method);
+#endif
+		}
+		else
+			ret = CallVector(callable, items, nargs, kwnames); //CallVector (New)
+	}
+
+	Py_XDECREF(kwnames);
+	if (context != nullptr)
+	{
+		for (size_t i = 0; i < filled; i++)
+			Py_XDECREF(items[i]);
+	}
+
+	return ret;
+}
+
+//Steals ret.
+Napi::Value NapiPyObject::MarshalReturnValue(const Napi::Env env, PyObject* ret,
+	const pyjs::MarshallingOptions& options)
+{
+	if (options.rawReference)
+	{
+		//Should we send this as an object type?
+		Napi::Value napiValue = NapiPyObject::NewInstance(env, {});
+		NapiPyObject* npo = Napi::ObjectWrap<NapiPyObject>::Unwrap(napiValue.As<Napi::Object>());
+		npo->SetPyObject(env, ret); //NapiPyObject now managing memory for ret
+		return napiValue;
+	}
+
+	pyjs::MarshallingContext::Lease context(env, options);
+	auto napiValue = pyjs::Py_ConvertToJavascript(env, ret, *context);
+
+	Py_DECREF(ret);
+
+	return napiValue;
+}
+
 pyjs::MarshallingOptions NapiPyObject::ProcessMarshallingOptions(const Napi::Value val)
 {
-	if (val.IsNull())
+	if (val.IsNull() || val.IsUndefined())
 	{
 		//Default options
 		return pyjs::MarshallingOptions();
@@ -288,6 +467,12 @@ pyjs::MarshallingOptions NapiPyObject::ProcessMarshallingOptions(const Napi::Val
 	Napi::Object obj = val.ToObject();
 	pyjs::MarshallingOptions mo = pyjs::MarshallingOptions(
 		obj.Get("getReference").ToBoolean().Value());
+	mo.safeIntegerAsNumber = obj.Get("safeIntegerAsNumber").ToBoolean().Value();
+	mo.zeroCopyBytes = obj.Get("zeroCopyBytes").ToBoolean().Value();
+	mo.typedArrays = obj.Get("typedArrays").ToBoolean().Value();
+	mo.numericArrays = obj.Get("numericArrays").ToBoolean().Value();
+	mo.dictAsObject = obj.Get("dictAsObject").ToBoolean().Value();
+	mo.recordsAsColumns = obj.Get("recordsAsColumns").ToBoolean().Value();
 
 	return mo;
 }
@@ -334,44 +519,429 @@ Napi::Value NapiPyObject::FunctionCall(const Napi::CallbackInfo &info)
 	Napi::Env env = info.Env();
 	Napi::EscapableHandleScope scope(env);
 
+	PyObject* pyObject = this->container_->get_pyObject();
+
 	//info[0] & info[1] are used for (args, kwargs)
-	auto pair = NapiPyObject::ProcessFunctionCallArguments(info);
-	if (!pair.first)
+	PY_CHECK_START();
+	PyObject* retValue = NapiPyObject::CallWithArguments(env, pyObject, info[0], info[1], nullptr); //CallWithArguments (New)
+	if (env.IsExceptionPending())
+	{
+		Py_XDECREF(retValue);
 		return env.Undefined();
+	}
+	PY_CHECK(env, retValue, NULL, env.Undefined());
+
+	//Use info[2] for marshalling options.
+	pyjs::MarshallingOptions mo = 
+		NapiPyObject::ProcessMarshallingOptions(info[2]);
+	return scope.Escape(napi_value(NapiPyObject::MarshalReturnValue(env, retValue, mo)));
+}
+
+//Same as FunctionCall, but (args, kwargs) hold plain JS values that are converted in one pass,
+//without a NapiPyObject per argument. Every argument shares one marshalling context.
+Napi::Value NapiPyObject::FunctionCallRaw(const Napi::CallbackInfo &info)
+{
+	Napi::Env env = info.Env();
+	Napi::EscapableHandleScope scope(env);
 
-	PyObject* args = pair.first;
-	PyObject* dict = pair.second;
 	PyObject* pyObject = this->container_->get_pyObject();
+	pyjs::MarshallingOptions mo = 
+		NapiPyObject::ProcessMarshallingOptions(info[2]);
 
 	PY_CHECK_START();
-	PyObject* retValue = PyObject_Call(pyObject, args, dict); //PyObject_Call (New)
-	Py_DECREF(args);
-	Py_DECREF(dict);
+	PyObject* retValue;
+	{
+		pyjs::MarshallingContext::Lease context(env, mo);
+		retValue = NapiPyObject::CallWithArguments(env, pyObject, info[0], info[1], &*context); //CallWithArguments (New)
+	}
+	if (env.IsExceptionPending())
+	{
+		Py_XDECREF(retValue);
+		return env.Undefined();
+	}
 	PY_CHECK(env, retValue, NULL, env.Undefined());
 
+	return scope.Escape(napi_value(NapiPyObject::MarshalReturnValue(env, retValue, mo)));
+}
+
+//Calls the object once per argument array in info[0], each holding plain JS values as with
+//FunctionCallRaw, and returns the results as one array. A failing call leaves its exception
+//in its result slot rather than aborting the batch. info[1] holds the marshalling options.
+Napi::Value NapiPyObject::FunctionCallBatch(const Napi::CallbackInfo &info)
+{
+	Napi::Env env = info.Env();
+	Napi::EscapableHandleScope scope(env);
+
+	PyObject* pyObject = this->container_->get_pyObject();
+	pyjs::MarshallingOptions mo = 
+		NapiPyObject::ProcessMarshallingOptions(info[1]);
+
+	if (!info[0].IsArray())
+	{
+		NAPI_ERROR(env, "Invalid Parameters. Expecting an array of argument arrays.");
+		return env.Undefined();
+	}
+
+	napi_value napi_sets = info[0];
+	napi_value napi_results;
+	uint32_t count = 0;
+
+	NAPI_DIRECT_START(env);
+	NAPI_DIRECT_FUNC(napi_get_array_length, napi_sets, &count);
+	NAPI_DIRECT_FUNC(napi_create_array_with_length, count, &napi_results);
+
+	for (uint32_t i = 0; i < count && !env.IsExceptionPending(); i++)
+	{
+		//Per call scopes keep handle usage flat however long the batch is.
+		Napi::HandleScope item_scope(env);
+
+		napi_value napi_args;
+		NAPI_DIRECT_FUNC(napi_get_element, napi_sets, i, &napi_args);
+		Napi::Value args(env, napi_args);
+		if (!args.IsArray())
+		{
+			NAPI_ERROR(env, "Invalid Parameters. Expecting an array of argument arrays.");
+			break;
+		}
+
+		PyObject* retValue;
+		{
+			pyjs::MarshallingContext::Lease context(env, mo);
+			retValue = NapiPyObject::CallWithArguments(env, pyObject, args, env.Undefined(), &*context); //CallWithArguments (New)
+		}
+
+		napi_value napi_item = NULL;
+		if (retValue == NULL && !env.IsExceptionPending())
+			napi_item = pyjs_utils::CreatePythonException(env);
+		else if (retValue != NULL && !env.IsExceptionPending())
+			napi_item = NapiPyObject::MarshalReturnValue(env, retValue, mo);
+		else
+			Py_XDECREF(retValue);
+
+		//Argument or result conversion failed; record the JS error in place of a result.
+		if (env.IsExceptionPending())
+		{
+			PyErr_Clear();
+			NAPI_DIRECT_FUNC(napi_get_and_clear_last_exception, &napi_item);
+		}
+
+		NAPI_DIRECT_FUNC(napi_set_element, napi_results, i, napi_item);
+	}
+
+	if (env.IsExceptionPending())
+		return env.Undefined();
+
+	return scope.Escape(napi_results);
+}
+
+//Opcodes for ExecutePlan; js/plan.js mirrors these.
+enum PlanOp
+{
+	Argument = 0,	//index: push args[index]
+	Literal,		//value: push value
+	GetAttr,		//name: pop obj, push obj.name
+	GetItem,		//pop key, pop obj, push obj[key]
+	Call,			//nargs, kwnames|null: pop kwargs, args & callable, push callable(*args, **kwargs)
+	BuildList,		//count: pop count items, push [items]
+	BuildTuple		//count: pop count items, push (items)
+};
+
+//Evaluates the flat op list in info[0] as a stack machine, with info[1] holding the plan's arguments.
+//Intermediates stay PyObjects; only the final value is marshalled, using the options in info[2].
+Napi::Value NapiPyObject::ExecutePlan(const Napi::CallbackInfo &info)
+{
+	Napi::Env env = info.Env();
+	Napi::EscapableHandleScope scope(env);
+
+	if (info.Length() < 2 || !info[0].IsArray() || !info[1].IsArray())
+	{
+		NAPI_ERROR(env, "Invalid Parameters. Expecting an op list and an argument array.");
+		return env.Undefined();
+	}
+
+	napi_value napi_ops = info[0];
+	napi_value napi_args = info[1];
 	pyjs::MarshallingOptions mo = 
 		NapiPyObject::ProcessMarshallingOptions(info[2]);
 
-	if (mo.rawReference)
+	uint32_t length = 0;
+	uint32_t pc = 0;
+	std::vector<PyObject*> stack;
+	const char* malformed = nullptr;
+
+	NAPI_DIRECT_START(env);
+	NAPI_DIRECT_FUNC(napi_get_array_length, napi_ops, &length);
+
+	auto operand = [&]() -> Napi::Value
 	{
-		//Should we send this as an object type?
-		Napi::Value napiValue = NapiPyObject::NewInstance(env, {});
-		NapiPyObject* npo = Napi::ObjectWrap<NapiPyObject>::Unwrap(napiValue.As<Napi::Object>());
-		npo->SetPyObject(env, retValue); //NapiPyObject now managing memory for retValue
-		return scope.Escape(napi_value(napiValue));
+		napi_value napi_ele = NULL;
+		if (pc >= length)
+			malformed = "Invalid plan. Missing operand.";
+		else if (napi_get_element(env, napi_ops, pc, &napi_ele) != napi_ok)
+			malformed = "Invalid plan. Unable to read operand.";
+		pc++;
+		return Napi::Value(env, napi_ele);
+	};
+	auto pop = [&]() -> PyObject*
+	{
+		PyObject* top = stack.back();
+		stack.pop_back();
+		return top;
+	};
+
+	{
+		pyjs::MarshallingContext::Lease context(env, mo);
+
+		while (pc < length && malformed == nullptr && !env.IsExceptionPending())
+		{
+			Napi::Value op = operand();
+			if (malformed != nullptr || !op.IsNumber())
+			{
+				malformed = "Invalid plan. Expecting an opcode.";
+				break;
+			}
+
+			PyObject* result = NULL;
+			switch (op.As<Napi::Number>().Int32Value())
+			{
+				case PlanOp::Argument:
+				{
+					Napi::Value index = operand();
+					napi_value napi_arg;
+					if (malformed != nullptr || !index.IsNumber() ||
+						napi_get_element(env, napi_args, index.As<Napi::Number>().Uint32Value(), &napi_arg) != napi_ok)
+					{
+						malformed = "Invalid plan. Bad argument index.";
+						break;
+					}
+					result = pyjs::Js_ConvertToPython(env, Napi::Value(env, napi_arg), *context).first;
+					break;
+				}
+				case PlanOp::Literal:
+				{
+					Napi::Value value = operand();
+					if (malformed == nullptr)
+						result = pyjs::Js_ConvertToPython(env, value, *context).first;
+					break;
+				}
+				case PlanOp::GetAttr:
+				{
+					Napi::Value name = operand();
+					if (malformed != nullptr || !name.IsString() || stack.empty())
+					{
+						malformed = "Invalid plan. Bad attribute access.";
+						break;
+					}
+					PyObject* attr_name = pyjs_utils::Js_StringToInternedKey(env, name); //Js_StringToInternedKey (New)
+					if (attr_name == NULL)
+						break;
+					PyObject* obj = pop();
+					result = PyObject_GetAttr(obj, attr_name); //PyObject_GetAttr (New)
+					Py_DECREF(obj);
+					Py_DECREF(attr_name);
+					break;
+				}
+				case PlanOp::GetItem:
+				{
+					if (stack.size() < 2)
+					{
+						malformed = "Invalid plan. Bad item access.";
+						break;
+					}
+					PyObject* key = pop();
+					PyObject* obj = pop();
+					result = PyObject_GetItem(obj, key); //PyObject_GetItem (New)
+					Py_DECREF(obj);
+					Py_DECREF(key);
+					break;
+				}
+				case PlanOp::Call:
+				{
+					Napi::Value count = operand();
+					Napi::Value names = operand();
+					if (malformed != nullptr || !count.IsNumber() || 
+						!(names.IsNull() || names.IsArray()))
+					{
+						malformed = "Invalid plan. Bad call.";
+						break;
+					}
+
+					size_t nargs = count.As<Napi::Number>().Uint32Value();
+					size_t nkwargs = names.IsArray() ? names.As<Napi::Array>().Length() : 0;
+					size_t total = nargs + nkwargs;
+					if (stack.size() < total + 1)
+					{
+						malformed = "Invalid plan. Bad call.";
+						break;
+					}
+
+					PyObject* kwnames = NULL;
+					if (nkwargs > 0)
+					{
+						kwnames = PyTuple_New(nkwargs); //PyTuple_New (New)
+						for (uint32_t i = 0; kwnames != NULL && i < nkwargs; i++)
+						{
+							PyObject* key = pyjs_utils::Js_StringToInternedKey(env, 
+								names.As<Napi::Array>().Get(i)); //Js_StringToInternedKey (New)
+							if (key == NULL)
+							{
+								Py_CLEAR(kwnames);
+								break;
+							}
+							PyTuple_SET_ITEM(kwnames, i, key); //PyTuple_SET_ITEM (Steals)
+						}
+						if (kwnames == NULL)
+							break;
+					}
+
+					//The callable sits just below its arguments, in the slot vectorcall may borrow.
+					PyObject** items = stack.data() + stack.size() - total;
+					result = CallVector(items[-1], items, nargs, kwnames); //CallVector (New)
+					Py_XDECREF(kwnames);
+					for (size_t i = 0; i <= total; i++)
+						Py_DECREF(pop());
+					break;
+				}
+				case PlanOp::BuildList:
+				case PlanOp::BuildTuple:
+				{
+					bool is_list = op.As<Napi::Number>().Int32Value() == PlanOp::BuildList;
+					Napi::Value count = operand();
+					if (malformed != nullptr || !count.IsNumber() ||
+						stack.size() < count.As<Napi::Number>().Uint32Value())
+					{
+						malformed = "Invalid plan. Bad sequence.";
+						break;
+					}
+
+					size_t n = count.As<Napi::Number>().Uint32Value();
+					result = is_list ? PyList_New(n) : PyTuple_New(n); //PyList_New/PyTuple_New (New)
+					if (result == NULL)
+						break;
+
+					//Items were pushed in order, so the last one is on top.
+					for (size_t i = n; i > 0; i--)
+					{
+						if (is_list)
+							PyList_SET_ITEM(result, i - 1, pop()); //PyList_SET_ITEM (Steals)
+						else
+							PyTuple_SET_ITEM(result, i - 1, pop()); //PyTuple_SET_ITEM (Steals)
+					}
+					break;
+				}
+				default:
+					malformed = "Invalid plan. Unknown opcode.";
+					break;
+			}
+
+			//A failed conversion may have left references with the identity table only.
+			if (env.IsExceptionPending())
+			{
+				Py_XDECREF(result);
+				break;
+			}
+			if (result == NULL)
+				break;
+			stack.push_back(result);
+		}
 	}
 
-	auto map = std::unique_ptr<std::unordered_map<PyObject*,napi_value>>
-		(new std::unordered_map<PyObject*,napi_value>());
+	if (malformed == nullptr && !env.IsExceptionPending() && !PyErr_Occurred() && stack.size() != 1)
+		malformed = "Invalid plan. Expecting exactly one result.";
 
-	//Use info[2] for marshalling options.
-	auto napiValue = pyjs::Py_ConvertToJavascript(env, retValue,
-		pyjs::PyjsConfigurationOptions::GetSerializationFilters(),
-		map, mo);
+	if (malformed != nullptr || env.IsExceptionPending() || PyErr_Occurred())
+	{
+		while (!stack.empty())
+			Py_DECREF(pop());
 
-	Py_DECREF(retValue);
+		if (env.IsExceptionPending())
+			PyErr_Clear();
+		else if (malformed != nullptr)
+		{
+			PyErr_Clear();
+			NAPI_ERROR(env, malformed);
+		}
+		else
+			pyjs_utils::ThrowPythonException(env);
+		return env.Undefined();
+	}
 
-	return scope.Escape(napi_value(napiValue));
+	return scope.Escape(napi_value(NapiPyObject::MarshalReturnValue(env, pop(), mo)));
+}
+
+//Looks up info[0] once. Plain functions and (bound) methods come back as the marker in info[2],
+//which the JS side calls through CallMethod; anything else is marshalled with the options in
+//info[1]. When info[3] is true, a missing attribute gives undefined instead of throwing.
+Napi::Value NapiPyObject::GetAttributeOrMethod(const Napi::CallbackInfo &info)
+{
+	Napi::Env env = info.Env();
+
+	PyObject* pyObject = this->container_->get_pyObject();
+	PyObject* attr_name = pyjs_utils::Js_StringToInternedKey(env, info[0].ToString()); //Js_StringToInternedKey (New)
+	if (attr_name == NULL)
+	{
+		pyjs_utils::ThrowPythonException(env);
+		return env.Undefined();
+	}
+
+	PyObject* attr = PyObject_GetAttr(pyObject, attr_name); //PyObject_GetAttr (New)
+	Py_DECREF(attr_name);
+	if (attr == NULL)
+	{
+		if (info[3].ToBoolean().Value() && PyErr_ExceptionMatches(PyExc_AttributeError))
+		{
+			PyErr_Clear();
+			return env.Undefined();
+		}
+		pyjs_utils::ThrowPythonException(env);
+		return env.Undefined();
+	}
+
+	if (PyMethod_Check(attr) || PyCFunction_Check(attr) || PyFunction_Check(attr))
+	{
+		Py_DECREF(attr);
+		return info[2];
+	}
+
+	pyjs::MarshallingContext::Lease context(env, NapiPyObject::ProcessMarshallingOptions(info[1]));
+	auto res = pyjs::Py_ConvertToJavascript(env, attr, *context);
+
+	Py_DECREF(attr);
+
+	return res;
+}
+
+//Calls pyObject.<info[0]>(...) with (args, kwargs) in info[1] & info[2] holding plain JS values,
+//without materialising the bound method. info[3] holds the marshalling options.
+Napi::Value NapiPyObject::CallMethod(const Napi::CallbackInfo &info)
+{
+	Napi::Env env = info.Env();
+	Napi::EscapableHandleScope scope(env);
+
+	PyObject* pyObject = this->container_->get_pyObject();
+	pyjs::MarshallingOptions mo = 
+		NapiPyObject::ProcessMarshallingOptions(info[3]);
+
+	PY_CHECK_START();
+	PyObject* method_name = pyjs_utils::Js_StringToInternedKey(env, info[0].ToString()); //Js_StringToInternedKey (New)
+	PY_CHECK(env, method_name, NULL, env.Undefined());
+	PY_CHECK_INCLUDE(method_name);
+
+	PyObject* retValue;
+	{
+		pyjs::MarshallingContext::Lease context(env, mo);
+		retValue = NapiPyObject::CallWithArguments(env, pyObject, info[1], info[2], &*context, method_name); //CallWithArguments (New)
+	}
+	if (env.IsExceptionPending())
+	{
+		Py_XDECREF(retValue);
+		Py_DECREF(method_name);
+		return env.Undefined();
+	}
+	PY_CHECK(env, retValue, NULL, env.Undefined());
+	Py_DECREF(method_name);
+
+	return scope.Escape(napi_value(NapiPyObject::MarshalReturnValue(env, retValue, mo)));
 }
 
 Napi::Value NapiPyObject::CloneReference(const Napi::CallbackInfo &info)
@@ -392,10 +962,12 @@ Napi::Value NapiPyObject::GetMarshaledObject(const Napi::CallbackInfo &info)
 	Napi::Env env = info.Env();
 	Napi::EscapableHandleScope scope(env);
 
-	const std::unique_ptr<const std::vector<Napi::Function>>&
-		serialization_filters = pyjs::PyjsConfigurationOptions::GetSerializationFilters();
-	std::pair<PyObject*,PyObjectType> conv = pyjs::Js_ConvertToPython(env, info[0],
-		serialization_filters);
+	std::pair<PyObject*,PyObjectType> conv;
+	{
+		//Use info[1] for marshalling options
+		pyjs::MarshallingContext::Lease context(env, NapiPyObject::ProcessMarshallingOptions(info[1]));
+		conv = pyjs::Js_ConvertToPython(env, info[0], *context);
+	}
 
 	if (env.IsExceptionPending())
 		return env.Undefined();
@@ -406,16 +978,13 @@ Napi::Value NapiPyObject::GetMarshaledObject(const Napi::CallbackInfo &info)
 	npo->SetPyObject(env, obj);
 	npo->SetObjectType(conv.second);
 
-	//Finalize
-	if (serialization_filters->size() > 0)
-		serialization_filters->operator[](2).Call({ });
-
 	return scope.Escape(napi_value(napiValue));
 }
 
 NapiPyObject::NapiPyObject(const Napi::CallbackInfo &info) : Napi::ObjectWrap<NapiPyObject>(info)
 {
 	container_ = new NapiPyObjectContainer();
+	napi_type_tag_object(info.Env(), info.This(), &napi_pyobject_tag_);
 }
 
 Napi::Object NapiPyObject::NewInstance(Napi::Env env, const std::vector<napi_value>& args)
@@ -433,25 +1002,129 @@ Napi::Value NapiPyObject::IsInstanceOf(const Napi::CallbackInfo &info)
 		NAPI_ERROR(env, "Invalid Parameters. Expecting more than one argument.");
 	}
 
-	napi_value napi_val = Napi::Value(info[0]);
-	napi_value constructor_ref;
+	return Napi::Boolean::New(info.Env(), IsInstanceOfNative(env, info[0]));
+}
+
+bool NapiPyObject::IsInstanceOfNative(Napi::Env env, Napi::Value val)
+{
+	napi_valuetype type;
+	if (napi_typeof(env, val, &type) != napi_ok || type != napi_object)
+		return false;
+
+	bool tagged = false;
+	return napi_check_object_type_tag(env, val, &napi_pyobject_tag_, &tagged) == napi_ok && tagged;
+}
+
+//Resolves a NapiPyObject or a marshalling proxy to its wrapper; nullptr for anything else.
+NapiPyObject* NapiPyObject::UnwrapMarshaled(Napi::Env env, Napi::Value val)
+{
+	napi_valuetype type;
+	if (napi_typeof(env, val, &type) != napi_ok || (type != napi_object && type != napi_function))
+		return nullptr;
+
+	bool tagged = false;
+	if (type == napi_object && 
+		napi_check_object_type_tag(env, val, &napi_pyobject_tag_, &tagged) == napi_ok && tagged)
+	{
+		return Napi::ObjectWrap<NapiPyObject>::Unwrap(val.As<Napi::Object>());
+	}
+
+	void* wrapper = nullptr;
+	if (napi_check_object_type_tag(env, val, &marshaled_proxy_tag_, &tagged) == napi_ok && tagged &&
+		napi_unwrap(env, val, &wrapper) == napi_ok)
+	{
+		return static_cast<NapiPyObject*>(wrapper);
+	}
+
+	return nullptr;
+}
+
+//Called once per marshalling proxy. The proxy target keeps the wrapper alive, so no finalizer is needed.
+Napi::Value NapiPyObject::TagMarshaledObject(const Napi::CallbackInfo &info)
+{
+	Napi::Env env = info.Env();
+
+	if (info.Length() < 2 || !IsInstanceOfNative(env, info[1]))
+	{
+		NAPI_ERROR(env, "Invalid Parameters. Expecting a proxy and a PyObject.");
+		return env.Undefined();
+	}
+
+	NapiPyObject* npo = Napi::ObjectWrap<NapiPyObject>::Unwrap(info[1].As<Napi::Object>());
 	NAPI_DIRECT_START(env);
-	NAPI_DIRECT_FUNC(napi_get_reference_value, NapiPyObject::constructor_, &constructor_ref);
-	bool instance_of = false;
-	NAPI_DIRECT_FUNC(napi_instanceof, napi_val, constructor_ref, &instance_of);
+	NAPI_DIRECT_FUNC(napi_type_tag_object, info[0], &marshaled_proxy_tag_);
+	NAPI_DIRECT_FUNC(napi_wrap, info[0], npo, nullptr, nullptr, nullptr);
 
-	return Napi::Boolean::New(info.Env(), instance_of);
+	return info[0];
 }
 
-bool NapiPyObject::IsInstanceOfNative(Napi::Env env, Napi::Value val)
+static void FinalizeMethodReference(napi_env env, void* data, void* hint)
+{
+	MethodReference* method = static_cast<MethodReference*>(data);
+
+	//V8 may collect after Python has been torn down, in which case there's nothing to release.
+	if (Py_IsInitialized())
+	{
+		lock_gil lock_me;
+		Py_DECREF(method->owner);
+		Py_DECREF(method->name);
+	}
+
+	delete method;
+}
+
+//Tags a method thunk (info[0]) as standing for info[1].<info[2]>.
+Napi::Value NapiPyObject::TagMethodReference(const Napi::CallbackInfo &info)
 {
-	napi_value napi_val = val;
-	napi_value constructor_ref;
+	Napi::Env env = info.Env();
+
+	if (info.Length() < 3 || !IsInstanceOfNative(env, info[1]) || !info[2].IsString())
+	{
+		NAPI_ERROR(env, "Invalid Parameters. Expecting a function, a PyObject and a name.");
+		return env.Undefined();
+	}
+
+	PyObject* name = pyjs_utils::Js_StringToInternedKey(env, info[2]); //Js_StringToInternedKey (New)
+	if (name == NULL)
+	{
+		pyjs_utils::ThrowPythonException(env);
+		return env.Undefined();
+	}
+
+	NapiPyObject* npo = Napi::ObjectWrap<NapiPyObject>::Unwrap(info[1].As<Napi::Object>());
+	MethodReference* method = new MethodReference{ npo->GetPyObject(env), name };
+	Py_INCREF(method->owner);
+
 	NAPI_DIRECT_START(env);
-	NAPI_DIRECT_FUNC(napi_get_reference_value, NapiPyObject::constructor_, &constructor_ref);
-	bool instance_of = false;
-	NAPI_DIRECT_FUNC(napi_instanceof, napi_val, constructor_ref, &instance_of);
-	return instance_of;
+	NAPI_DIRECT_FUNC(napi_type_tag_object, info[0], &method_reference_tag_);
+	if (napi_wrap(env, info[0], method, FinalizeMethodReference, nullptr, nullptr) != napi_ok)
+	{
+		FinalizeMethodReference(env, method, nullptr);
+		NAPI_ERROR(env, "Unable to tag method reference.");
+		return env.Undefined();
+	}
+
+	return info[0];
+}
+
+//For a method thunk, sets *obj to the bound attribute (New; NULL with a Python error set) and returns true.
+bool NapiPyObject::ResolveMethodReference(Napi::Env env, Napi::Value val, PyObject** obj)
+{
+	napi_valuetype type;
+	if (napi_typeof(env, val, &type) != napi_ok || type != napi_function)
+		return false;
+
+	bool tagged = false;
+	void* data = nullptr;
+	if (napi_check_object_type_tag(env, val, &method_reference_tag_, &tagged) != napi_ok || !tagged ||
+		napi_unwrap(env, val, &data) != napi_ok)
+	{
+		return false;
+	}
+
+	MethodReference* method = static_cast<MethodReference*>(data);
+	*obj = PyObject_GetAttr(method->owner, method->name); //PyObject_GetAttr (New)
+	return true;
 }
 
 void NapiPyObject::SetPyObject(Napi::Env env, PyObject* pyObject)
@@ -25,12 +25,19 @@
 
 #include "pyjs_.h"
 #include "napi_callback.hpp"
+#include <datetime.h>
+#include <cmath>
+#include <ctime>
+#include <deque>
+#include <list>
+#include <string_view>
 
 ////////////////////////////////////////////
 // Exceptions
 ////////////////////////////////////////////
 
-void pyjs_utils::ThrowPythonException(Napi::Env env)
+//Takes the pending Python error and wraps it in a JS PythonException.
+Napi::Value pyjs_utils::CreatePythonException(Napi::Env env)
 {
 	auto p_ex = pyjs_utils::GetPythonException();
 	auto napiEx = NapiPyObject::NewInstance(env, {});
@@ -43,17 +50,514 @@ void pyjs_utils::ThrowPythonException(Napi::Env env)
 	exObj.Set("message", p_ex.first);
 	exObj.Set("exception", napiEx);
 
-	Napi::Value ex = NapiPyObject::serialization_callback_.Call(
+	return NapiPyObject::serialization_callback_.Call(
 	{
 		Napi::Number::New(env, PyObjectType::Python_Exception),
 		exObj
 	});
+}
 
+void pyjs_utils::ThrowPythonException(Napi::Env env)
+{
+	Napi::Value ex = pyjs_utils::CreatePythonException(env);
 
 	NAPI_DIRECT_START(env);
 	NAPI_DIRECT_FUNC(napi_throw, ex);
 }
 
+////////////////////////////////////////////
+// Strings
+////////////////////////////////////////////
+
+napi_value pyjs_utils::Py_UnicodeToNapiString(const Napi::Env env, PyObject* obj)
+{
+#if PY_VERSION_HEX < 0x030C0000
+	if (PyUnicode_READY(obj) < 0)
+		return NULL;
+#endif
+
+	//Hand V8 the string's own storage where the encodings line up; no intermediate copies.
+	napi_value napi_string = NULL;
+	napi_status status;
+	Py_ssize_t length = PyUnicode_GET_LENGTH(obj);
+
+	switch (PyUnicode_KIND(obj))
+	{
+		case PyUnicode_1BYTE_KIND: //ASCII & Latin-1
+			status = napi_create_string_latin1(env,
+				reinterpret_cast<const char*>(PyUnicode_1BYTE_DATA(obj)), length, &napi_string);
+			break;
+		case PyUnicode_2BYTE_KIND: //UCS-2 (BMP)
+			status = napi_create_string_utf16(env,
+				reinterpret_cast<const char16_t*>(PyUnicode_2BYTE_DATA(obj)), length, &napi_string);
+			break;
+		default: //UCS-4, needs surrogate pairs; let Python encode it.
+		{
+			Py_ssize_t size;
+			const char* utf8 = PyUnicode_AsUTF8AndSize(obj, &size);
+			if (utf8 == NULL)
+				return NULL;
+			status = napi_create_string_utf8(env, utf8, size, &napi_string);
+			break;
+		}
+	}
+
+	if (status != napi_ok)
+	{
+		PyErr_SetString(PyExc_MemoryError, "Unable to create Javascript string.");
+		return NULL;
+	}
+
+	return napi_string;
+}
+
+//Per-thread scratch space for reading JS strings, reused across calls up to this many UTF-16 units.
+//Anything larger is released once converted, so one huge string doesn't pin its buffer for good.
+static const size_t SCRATCH_RETAINED_CAPACITY = 64 * 1024;
+static thread_local std::vector<char16_t> js_string_scratch;
+
+static const char16_t* ReadJsString(const Napi::Env env, napi_value val, size_t* length)
+{
+	if (napi_get_value_string_utf16(env, val, NULL, 0, length) != napi_ok)
+	{
+		PyErr_SetString(PyExc_TypeError, "Expected a Javascript string.");
+		return NULL;
+	}
+
+	if (js_string_scratch.size() < *length + 1)
+		js_string_scratch.resize(*length + 1);
+
+	napi_get_value_string_utf16(env, val, js_string_scratch.data(), *length + 1, length);
+	return js_string_scratch.data();
+}
+
+//Call once the units returned by ReadJsString are no longer needed.
+static void ReleaseJsString()
+{
+	if (js_string_scratch.capacity() > SCRATCH_RETAINED_CAPACITY)
+		std::vector<char16_t>().swap(js_string_scratch);
+}
+
+static PyObject* PyUnicodeFromUtf16(const char16_t* units, size_t length)
+{
+	char16_t max_char = 0;
+	bool has_surrogates = false;
+	for (size_t i = 0; i < length; i++)
+	{
+		max_char = units[i] > max_char ? units[i] : max_char;
+		has_surrogates |= (units[i] & 0xF800) == 0xD800;
+	}
+
+	//Pairs (and lone surrogates, which JS allows) need decoding into UCS-4.
+	if (has_surrogates)
+	{
+		int byte_order = PY_LITTLE_ENDIAN ? -1 : 1;
+		return PyUnicode_DecodeUTF16(reinterpret_cast<const char*>(units),
+			static_cast<Py_ssize_t>(length * sizeof(char16_t)), "surrogatepass", &byte_order); //PyUnicode_DecodeUTF16 (New)
+	}
+
+	PyObject* obj = PyUnicode_New(static_cast<Py_ssize_t>(length), max_char); //PyUnicode_New (New)
+	if (obj == NULL)
+		return NULL;
+
+	if (PyUnicode_KIND(obj) == PyUnicode_1BYTE_KIND)
+	{
+		Py_UCS1* data = PyUnicode_1BYTE_DATA(obj);
+		for (size_t i = 0; i < length; i++)
+			data[i] = static_cast<Py_UCS1>(units[i]);
+	}
+	else
+	{
+		memcpy(PyUnicode_2BYTE_DATA(obj), units, length * sizeof(char16_t));
+	}
+
+	return obj;
+}
+
+PyObject* pyjs_utils::Js_StringToPyUnicode(const Napi::Env env, napi_value val)
+{
+	size_t length;
+	const char16_t* units = ReadJsString(env, val, &length);
+	if (units == NULL)
+		return NULL;
+
+	PyObject* obj = PyUnicodeFromUtf16(units, length); //PyUnicodeFromUtf16 (New)
+	ReleaseJsString();
+	return obj;
+}
+
+////////////////////////////////////////////
+// Interned Keys
+////////////////////////////////////////////
+
+//Object keys and kwarg names repeat across records, so keep interned copies keyed by their UTF-16 content.
+//Only touched with the GIL held. Views in entries point into storage, which never moves its elements.
+static const size_t KEY_CACHE_CAPACITY = 4096;
+static const size_t KEY_CACHE_MAX_LENGTH = 64;
+
+static struct
+{
+	std::unordered_map<std::u16string_view, PyObject*> entries;
+	std::deque<std::u16string> storage;
+	size_t hits = 0;
+	size_t misses = 0;
+} key_cache;
+
+PyObject* pyjs_utils::Js_StringToInternedKey(const Napi::Env env, napi_value val)
+{
+	size_t length;
+	const char16_t* units = ReadJsString(env, val, &length);
+	if (units == NULL)
+		return NULL;
+
+	//Long strings are unlikely to be keys; don't let them crowd the cache.
+	if (length > KEY_CACHE_MAX_LENGTH)
+	{
+		PyObject* obj = PyUnicodeFromUtf16(units, length); //PyUnicodeFromUtf16 (New)
+		ReleaseJsString();
+		return obj;
+	}
+
+	auto it = key_cache.entries.find(std::u16string_view(units, length));
+	if (it != key_cache.entries.end())
+	{
+		key_cache.hits++;
+		Py_INCREF(it->second); //Clone.
+		return it->second;
+	}
+
+	key_cache.misses++;
+	PyObject* key = PyUnicodeFromUtf16(units, length); //PyUnicodeFromUtf16 (New)
+	if (key == NULL)
+		return NULL;
+	PyUnicode_InternInPlace(&key);
+
+	if (key_cache.entries.size() >= KEY_CACHE_CAPACITY)
+		pyjs_utils::ClearKeyCache();
+
+	key_cache.storage.emplace_back(units, length);
+	key_cache.entries.emplace(std::u16string_view(key_cache.storage.back()), key);
+	Py_INCREF(key); //Cache reference.
+
+	return key;
+}
+
+void pyjs_utils::ClearKeyCache()
+{
+	for (auto& entry : key_cache.entries)
+		Py_DECREF(entry.second);
+
+	key_cache.entries.clear();
+	key_cache.storage.clear();
+}
+
+pyjs_utils::CacheStats pyjs_utils::GetKeyCacheStats()
+{
+	return { key_cache.hits, key_cache.misses, key_cache.entries.size(), KEY_CACHE_CAPACITY };
+}
+
+////////////////////////////////////////////
+// String Handles
+////////////////////////////////////////////
+
+//LRU of V8 strings for interned PyUnicode, keyed by identity. Each entry holds a reference to its
+//key so the address can't be reused while cached. N-API can't reference primitives, so the strings
+//live in the slots of one persistent array.
+static const size_t STRING_CACHE_CAPACITY = 2048;
+
+struct CachedString
+{
+	PyObject* key;
+	uint32_t slot;
+};
+
+static struct
+{
+	napi_ref slots = nullptr;
+	std::list<CachedString> lru; //Most recently used first.
+	std::unordered_map<PyObject*, std::list<CachedString>::iterator> index;
+	size_t hits = 0;
+	size_t misses = 0;
+} string_cache;
+
+napi_value pyjs_utils::Py_UnicodeToCachedNapiString(const Napi::Env env, PyObject* obj)
+{
+	//Only interned strings (identifiers, literal keys) recur by identity.
+	if (!PyUnicode_CHECK_INTERNED(obj))
+		return pyjs_utils::Py_UnicodeToNapiString(env, obj);
+
+	napi_value slots;
+	if (string_cache.slots == nullptr)
+	{
+		if (napi_create_array_with_length(env, STRING_CACHE_CAPACITY, &slots) != napi_ok ||
+			napi_create_reference(env, slots, 1, &string_cache.slots) != napi_ok)
+			return pyjs_utils::Py_UnicodeToNapiString(env, obj);
+	}
+	else if (napi_get_reference_value(env, string_cache.slots, &slots) != napi_ok)
+	{
+		return pyjs_utils::Py_UnicodeToNapiString(env, obj);
+	}
+
+	napi_value napi_string;
+	auto it = string_cache.index.find(obj);
+	if (it != string_cache.index.end())
+	{
+		string_cache.hits++;
+		string_cache.lru.splice(string_cache.lru.begin(), string_cache.lru, it->second);
+		if (napi_get_element(env, slots, it->second->slot, &napi_string) == napi_ok)
+			return napi_string;
+		return pyjs_utils::Py_UnicodeToNapiString(env, obj);
+	}
+
+	string_cache.misses++;
+	napi_string = pyjs_utils::Py_UnicodeToNapiString(env, obj);
+	if (napi_string == NULL)
+		return NULL;
+
+	//Recycle the least recently used slot when full, evicting its entry only once the slot
+	//really holds the new string; slots in use are always exactly [0, lru.size()).
+	bool full = string_cache.lru.size() >= STRING_CACHE_CAPACITY;
+	uint32_t slot = full ? string_cache.lru.back().slot : static_cast<uint32_t>(string_cache.lru.size());
+	if (napi_set_element(env, slots, slot, napi_string) != napi_ok)
+		return napi_string;
+
+	if (full)
+	{
+		CachedString& oldest = string_cache.lru.back();
+		string_cache.index.erase(oldest.key);
+		Py_DECREF(oldest.key);
+		string_cache.lru.pop_back();
+	}
+
+	Py_INCREF(obj); //Cache reference.
+	string_cache.lru.push_front({ obj, slot });
+	string_cache.index.emplace(obj, string_cache.lru.begin());
+
+	return napi_string;
+}
+
+void pyjs_utils::ClearStringCache(const Napi::Env env)
+{
+	for (CachedString& entry : string_cache.lru)
+		Py_DECREF(entry.key);
+
+	string_cache.lru.clear();
+	string_cache.index.clear();
+
+	if (string_cache.slots != nullptr)
+	{
+		napi_delete_reference(env, string_cache.slots);
+		string_cache.slots = nullptr;
+	}
+}
+
+pyjs_utils::CacheStats pyjs_utils::GetStringCacheStats()
+{
+	return { string_cache.hits, string_cache.misses, string_cache.lru.size(), STRING_CACHE_CAPACITY };
+}
+
+////////////////////////////////////////////
+// Code Objects
+////////////////////////////////////////////
+
+//LRU of compiled code keyed by (mode, tag, source). eval() callers tend to run the same few
+//snippets repeatedly; code objects are immutable, so sharing them between evaluations is safe.
+static const size_t CODE_CACHE_CAPACITY = 256;
+
+struct CachedCode
+{
+	std::string key;
+	PyObject* code;
+};
+
+static struct
+{
+	std::list<CachedCode> lru; //Most recently used first.
+	std::unordered_map<std::string_view, std::list<CachedCode>::iterator> index;
+	size_t hits = 0;
+	size_t misses = 0;
+} code_cache;
+
+PyObject* pyjs_utils::Py_CompileStringCached(const std::string& source, const std::string& tag, int mode)
+{
+	std::string key;
+	key.reserve(source.size() + tag.size() + 2);
+	key.push_back(static_cast<char>(mode));
+	key.append(tag);
+	key.push_back('\0');
+	key.append(source);
+
+	auto it = code_cache.index.find(key);
+	if (it != code_cache.index.end())
+	{
+		code_cache.hits++;
+		code_cache.lru.splice(code_cache.lru.begin(), code_cache.lru, it->second);
+		Py_INCREF(it->second->code); //Clone.
+		return it->second->code;
+	}
+
+	code_cache.misses++;
+	PyObject* code = Py_CompileString(source.c_str(), tag.c_str(), mode); //Py_CompileString (New)
+	if (code == NULL)
+		return NULL;
+
+	if (code_cache.lru.size() >= CODE_CACHE_CAPACITY)
+	{
+		CachedCode& oldest = code_cache.lru.back();
+		code_cache.index.erase(oldest.key);
+		Py_DECREF(oldest.code);
+		code_cache.lru.pop_back();
+	}
+
+	code_cache.lru.push_front({ std::move(key), code });
+	code_cache.index.emplace(std::string_view(code_cache.lru.front().key), code_cache.lru.begin());
+	Py_INCREF(code); //Cache reference.
+
+	return code;
+}
+
+void pyjs_utils::ClearCodeCache()
+{
+	for (CachedCode& entry : code_cache.lru)
+		Py_DECREF(entry.code);
+
+	code_cache.lru.clear();
+	code_cache.index.clear();
+}
+
+pyjs_utils::CacheStats pyjs_utils::GetCodeCacheStats()
+{
+	return { code_cache.hits, code_cache.misses, code_cache.lru.size(), CODE_CACHE_CAPACITY };
+}
+
+////////////////////////////////////////////
+// Dates
+////////////////////////////////////////////
+
+bool pyjs_utils::InitDateTime()
+{
+	if (PyDateTimeAPI == NULL)
+		PyDateTime_IMPORT; //PyCapsule_Import (Borrowed)
+
+	if (PyDateTimeAPI == NULL)
+	{
+		PyErr_Clear(); //datetime is unavailable, leave datetimes as proxies.
+		return false;
+	}
+
+	return true;
+}
+
+bool pyjs_utils::Py_IsDateTime(PyObject* obj)
+{
+	return PyDateTimeAPI != NULL && PyDateTime_CheckExact(obj);
+}
+
+//Days since 1970-01-01 in the proleptic Gregorian calendar.
+static int64_t DaysFromCivil(int64_t y, unsigned m, unsigned d)
+{
+	y -= m <= 2;
+	const int64_t era = (y >= 0 ? y : y - 399) / 400;
+	const unsigned yoe = static_cast<unsigned>(y - era * 400);
+	const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+	const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+PyObject* pyjs_utils::Js_DateToPyDateTime(const Napi::Env env, napi_value val)
+{
+	double time;
+	if (napi_get_date_value(env, val, &time) != napi_ok)
+	{
+		PyErr_SetString(PyExc_TypeError, "Expected a Javascript Date.");
+		return NULL;
+	}
+
+	if (std::isnan(time))
+	{
+		PyErr_SetString(PyExc_ValueError, "Unable to marshal an invalid Date to Python.");
+		return NULL;
+	}
+
+	if (!pyjs_utils::InitDateTime())
+	{
+		PyErr_SetString(PyExc_ImportError, "The datetime module is unavailable.");
+		return NULL;
+	}
+
+	//Matches datetime.fromtimestamp, producing a naive local datetime.
+	PyObject* args = Py_BuildValue("(d)", time / 1000.0); //Py_BuildValue (New)
+	if (args == NULL)
+		return NULL;
+
+	PyObject* obj = PyDateTime_FromTimestamp(args); //PyDateTime_FromTimestamp (New)
+	Py_DECREF(args);
+	return obj;
+}
+
+napi_value pyjs_utils::Py_DateTimeToNapiDate(const Napi::Env env, PyObject* obj)
+{
+	PyObject* offset = PyObject_CallMethod(obj, "utcoffset", NULL); //PyObject_CallMethod (New)
+	if (offset == NULL)
+		return nullptr;
+
+	double time;
+	int64_t seconds = PyDateTime_DATE_GET_HOUR(obj) * 3600 +
+		PyDateTime_DATE_GET_MINUTE(obj) * 60 +
+		PyDateTime_DATE_GET_SECOND(obj);
+	double millis = PyDateTime_DATE_GET_MICROSECOND(obj) / 1000.0;
+
+	if (PyDelta_Check(offset))
+	{
+		//Aware: the fields are local to the offset, so shift them back to UTC.
+		seconds -= static_cast<int64_t>(PyDateTime_DELTA_GET_DAYS(offset)) * 86400 +
+			PyDateTime_DELTA_GET_SECONDS(offset);
+		millis -= PyDateTime_DELTA_GET_MICROSECONDS(offset) / 1000.0;
+
+		int64_t days = DaysFromCivil(PyDateTime_GET_YEAR(obj),
+			PyDateTime_GET_MONTH(obj), PyDateTime_GET_DAY(obj));
+		time = static_cast<double>(days * 86400 + seconds) * 1000.0 + millis;
+	}
+	else
+	{
+		//Naive: local time, as datetime.timestamp would interpret it.
+		struct tm local = {};
+		local.tm_year = PyDateTime_GET_YEAR(obj) - 1900;
+		local.tm_mon = PyDateTime_GET_MONTH(obj) - 1;
+		local.tm_mday = PyDateTime_GET_DAY(obj);
+		local.tm_hour = PyDateTime_DATE_GET_HOUR(obj);
+		local.tm_min = PyDateTime_DATE_GET_MINUTE(obj);
+		local.tm_sec = PyDateTime_DATE_GET_SECOND(obj);
+		local.tm_isdst = -1;
+
+		time_t epoch = mktime(&local);
+		if (epoch == static_cast<time_t>(-1))
+		{
+			//Out of the platform's range, let Python work it out.
+			PyObject* timestamp = PyObject_CallMethod(obj, "timestamp", NULL); //PyObject_CallMethod (New)
+			if (timestamp == NULL)
+			{
+				Py_DECREF(offset);
+				return nullptr;
+			}
+			time = PyFloat_AsDouble(timestamp) * 1000.0;
+			Py_DECREF(timestamp);
+		}
+		else
+		{
+			time = static_cast<double>(epoch) * 1000.0 + millis;
+		}
+	}
+
+	Py_DECREF(offset);
+
+	napi_value result;
+	if (napi_create_date(env, time, &result) != napi_ok)
+		return nullptr;
+
+	return result;
+}
+
 ////////////////////////////////////////////
 // Debug?
 ////////////////////////////////////////////
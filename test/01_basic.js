@@ -65,6 +65,103 @@ describe('pyjs: basic functions', function() {
 		})
 	})
 
+	describe('[pyjs] #stats()', function() {
+		it('reports key cache hits for repeated record keys', function() {
+			let before = p.stats().keyCache
+			let records = [{ stats_a: 1.5, stats_b: 'x' }, { stats_a: 2.5, stats_b: 'y' }]
+			assert.isTrue(p.import('01_basic').basic_records_j(records))
+			let after = p.stats().keyCache
+			assert.isAtLeast(after.hits - before.hits, 2)
+			assert.isAtMost(after.size, after.capacity)
+		})
+
+		it('reports string cache hits for repeated Python keys', function() {
+			let before = p.stats().stringCache
+			let records = p.import('01_basic').basic_records()
+			assert.strictEqual(records.length, 3)
+			records.forEach(r => assert.deepEqual([...r.keys()], ['stats_alpha', 'stats_beta']))
+			let after = p.stats().stringCache
+			assert.isAtLeast(after.hits - before.hits, 4)
+			assert.isAtMost(after.size, after.capacity)
+		})
+	})
+
+	describe('[pyjs] #compile()', function() {
+		it('evaluates an expression with bound variables', function() {
+			let scale = p.compile('x * factor + offset')
+			assert.strictEqual(scale({ x: 2.5, factor: 2, offset: 1 }), 6)
+			assert.strictEqual(scale({ x: 1.5, factor: 4, offset: 0.5 }), 6.5)
+		})
+
+		it('runs statements in exec mode without leaking locals', function() {
+			let run = p.compile('compiled_total = sum(items)', { mode: 'exec' })
+			assert.isNull(run({ items: [1.5, 2.5] }))
+			assert.throws(() => p.compile('compiled_total')(), p.exceptions().PythonException)
+		})
+
+		it('reuses cached code for repeated eval() sources', function() {
+			p.eval('1 + 1')
+			let before = p.stats().codeCache
+			p.eval('1 + 1')
+			p.compile('1 + 1')
+			let after = p.stats().codeCache
+			assert.strictEqual(after.hits - before.hits, 2)
+			assert.strictEqual(after.misses, before.misses)
+			assert.isAtMost(after.size, after.capacity)
+		})
+
+		it('reports syntax errors when compiling', function() {
+			assert.throws(() => p.compile('1 +'), p.exceptions().PythonException)
+			assert.throws(() => p.compile('1', { mode: 'single' }), Error)
+		})
+	})
+
+	describe('[pyjs] #eval() bindings and namespaces', function() {
+		it('binds JS values as Python variables', function() {
+			assert.strictEqual(p.eval('len(name) + n', { bindings: { name: 'あいう', n: 2n } }), 5n)
+			assert.deepStrictEqual(p.eval('[r["a"] for r in rows]', { bindings: { rows: [{ a: 1.5 }, { a: 2.5 }] } }),
+				[1.5, 2.5])
+		})
+
+		it('makes bindings visible to nested scopes', function() {
+			let bindings = { xs: [1.5, 2.5], k: 2 }
+			assert.strictEqual(p.eval('sum(x * k for x in xs)', { bindings }), 8)
+			assert.strictEqual(p.eval('(lambda a: a * k)(xs[0])', { bindings }), 3)
+			assert.strictEqual(p.compile('sum(x * k for x in xs)')(bindings), 8)
+			let run = p.compile('def scaled(a):\n\treturn a * k\nassert scaled(xs[1]) == 5', { mode: 'exec' })
+			assert.isNull(run(bindings))
+		})
+
+		it('writes globals to __main__ when there are no bindings', function() {
+			p.evalAsFile('def set_main(v):\n\tglobal main_value\n\tmain_value = v\nset_main(3)', '=main.py')
+			assert.strictEqual(p.eval('main_value'), 3n)
+			p.eval('globals().update(main_other=4)')
+			assert.strictEqual(p.import('__main__').main_other, 4n)
+			assert.strictEqual(p.eval('main_value + k', { bindings: { k: 1n } }), 4n)
+		})
+
+		it('does not treat bound strings as code', function() {
+			assert.strictEqual(p.eval('s', { bindings: { s: '__import__("os")' } }), '__import__("os")')
+		})
+
+		it('keeps state across evaluations in a namespace', function() {
+			let ns = p.namespace({ start: 10n })
+			p.evalAsFile('def bump(by):\n\tglobal start\n\tstart += by\n\treturn start', '=ns.py', { namespace: ns })
+			assert.strictEqual(p.eval('bump(n)', { namespace: ns, bindings: { n: 5n } }), 15n)
+			assert.strictEqual(p.compile('bump(1)')({}, { namespace: ns }), 16n)
+			assert.strictEqual(p.eval('n', { namespace: ns }), 5n)
+			assert.throws(() => p.eval('start'), p.exceptions().PythonException)
+		})
+
+		it('rejects invalid bindings and namespaces', function() {
+			assert.throws(() => p.eval('1', { bindings: 1 }), Error)
+			for (let i = 0; i < 16; i++)
+				assert.throws(() => p.eval('a', { bindings: { a: [1.5, Symbol()] } }), Error)
+			assert.throws(() => p.eval('1', { namespace: {} }), Error)
+			assert.throws(() => p.eval('1', { namespace: p.import('01_basic') }), Error)
+		})
+	})
+
 	describe('[pyjs] $coerceAs', function() {
 		it('should exist', function() {
 			assert.exists(p.$coerceAs)
@@ -126,6 +223,11 @@ describe('pyjs: basic functions', function() {
 		it('01_basic#basic_int() returns 1789n', function() {
 			assert.strictEqual(p.import('01_basic').basic_int(), 1789n)
 		})
+
+		it('01_basic#basic_int_large() returns multi-word bigints of both signs', function() {
+			assert.deepStrictEqual(p.import('01_basic').basic_int_large(),
+				[2n**200n, -(2n**200n) - 1n, -(2n**63n), 2n**64n - 1n])
+		})
 	})
 
 	describe('[py->js] float to float', function() {
@@ -166,6 +268,11 @@ describe('pyjs: basic functions', function() {
 		it('01_basic#basic_string() returns "this is a string"', function() {
 			assert.strictEqual(p.import('01_basic').basic_string(), "this is a string")
 		})
+
+		it('01_basic#basic_string_kinds() returns latin-1, ucs-2, ucs-4 and embedded nul strings', function() {
+			assert.deepStrictEqual(p.import('01_basic').basic_string_kinds(),
+				['caf\u00e9 \u00ff', '\u3042\u3044\u3046', 'emoji \u{1F600}!', 'nul\u0000inside', ''])
+		})
 	})
 
 	describe('[py->js] tuple to array', function() {
@@ -222,6 +329,20 @@ describe('pyjs: basic functions', function() {
 		})
 	})
 
+	describe('[py->js] datetime to date', function() {
+		it('01_basic#basic_datetime() returns local 2019-01-04 12:55:11.014', function() {
+			let date = p.import('01_basic').basic_datetime()
+			assert.instanceOf(date, Date)
+			assert.strictEqual(date.getTime(), new Date(2019, 0, 4, 12, 55, 11, 14).getTime())
+		})
+
+		it('01_basic#basic_datetime_aware() honours the utc offset', function() {
+			let date = p.import('01_basic').basic_datetime_aware()
+			assert.instanceOf(date, Date)
+			assert.strictEqual(date.getTime(), Date.UTC(2019, 0, 4, 3, 55, 11, 14))
+		})
+	})
+
 	describe('[py->js] function to function', function() {
 		it('01_basic#basic_function() returns a function (() => 1.1*2)', function() {
 			assert.exists(p.import('01_basic').basic_function().$isCallable)
@@ -306,6 +427,10 @@ describe('pyjs: basic functions', function() {
 		it('01_basic#basic_int_j(98359834579n) returns true', function() {
 			assert.isTrue(p.import('01_basic').basic_int_j(98359834579n))
 		})
+
+		it('01_basic#basic_int_large_j(2n**521n - 1n, -(2n**64n) - 1n) returns true', function() {
+			assert.isTrue(p.import('01_basic').basic_int_large_j(2n**521n - 1n, -(2n**64n) - 1n))
+		})
 	})
 
 	describe('[js->py] float to float', function() {
@@ -318,6 +443,15 @@ describe('pyjs: basic functions', function() {
 		it('01_basic#basic_string_j("あいうえお") returns true', function() {
 			assert.isTrue(p.import('01_basic').basic_string_j('あいうえお'))
 		})
+
+		it('01_basic#basic_string_kinds_j() receives latin-1, ucs-2, ucs-4, nul and lone surrogate strings', function() {
+			assert.isTrue(p.import('01_basic').basic_string_kinds_j(
+				['caf\u00e9 \u00ff', '\u3042\u3044\u3046', 'emoji \u{1F600}!', 'nul\u0000inside', '', '\uD800x']))
+		})
+
+		it('01_basic#basic_echo_tester() round-trips a lone surrogate', function() {
+			assert.strictEqual(p.import('01_basic').basic_echo_tester('a\uDC00'), 'a\uDC00')
+		})
 	})
 
 	describe('[js->py] tuple (coerce) to tuple', function() {
@@ -351,15 +485,120 @@ describe('pyjs: basic functions', function() {
 		})
 	})
 
-	//This bugs out on 3.8.0 on Linux for unknown reasons...
-	/*it('[js->py] date to datetime', function() {
-		let date = new Date(2019, 0, 4, 12, 55, 11, 14)
-		assert.isTrue(p.import('01_basic').basic_datetime_j(date))
-	})*/
-	/*
-		PythonException [#ImportError]: ImportError: /home/travis/.pyenv/versions/3.8.0/lib/python3.8/lib-dynload/math.cpython-38-x86_64-linux-gnu.so: undefined symbol: PyFloat_Type
-		ImportError: /home/travis/.pyenv/versions/3.8.0/lib/python3.8/lib-dynload/math.cpython-38-x86_64-linux-gnu.so: undefined symbol: PyFloat_Type
-	*/
+	describe('[js->py] date to datetime', function() {
+		it('01_basic#basic_datetime_j(new Date(2019, 0, 4, 12, 55, 11, 14))', function() {
+			let date = new Date(2019, 0, 4, 12, 55, 11, 14)
+			assert.isTrue(p.import('01_basic').basic_datetime_j(date))
+		})
+
+		it('01_basic#basic_datetime_utc_j(Date.UTC(...)) is local time', function() {
+			let date = new Date(Date.UTC(2019, 0, 4, 3, 55, 11, 14))
+			assert.isTrue(p.import('01_basic').basic_datetime_utc_j(date))
+		})
+
+		it('invalid dates throw', function() {
+			assert.throws(() => p.import('01_basic').basic_echo_tester(new Date(NaN)))
+		})
+	})
+
+	describe('[js->py] function call arguments', function() {
+		it('01_basic#basic_call_j(1.5) uses defaults', function() {
+			assert.deepStrictEqual(p.import('01_basic').basic_call_j(1.5), [1.5, 2.5, [], []])
+		})
+
+		it('01_basic#basic_call_j.$apply({a, b, c}) passes keywords', function() {
+			assert.deepStrictEqual(p.import('01_basic').basic_call_j.$apply({ c: 'z', a: 'x', b: 'y' }),
+				['x', 'y', [], [['c', 'z']]])
+		})
+
+		it('01_basic#basic_call_j.$apply([..], {..}) mixes positional and keywords', function() {
+			assert.deepStrictEqual(p.import('01_basic').basic_call_j.$apply([1.5, 3.5, 4.5], { d: null }),
+				[1.5, 3.5, [4.5], [['d', null]]])
+		})
+
+		it('01_basic#basic_call_j() with more than 8 arguments', function() {
+			let args = [...Array(12).keys()].map(x => x + 0.5)
+			assert.deepStrictEqual(p.import('01_basic').basic_call_j(...args),
+				[0.5, 1.5, args.slice(2), []])
+		})
+
+		it('01_basic#basic_call_j.$apply([1.5], {a}) raises a Python TypeError', function() {
+			assert.throws(() => p.import('01_basic').basic_call_j.$apply([1.5], { a: 2.5 }),
+				p.exceptions().PythonException)
+		})
+	})
+
+	describe('[js->py] batched function calls', function() {
+		it('01_basic#basic_call_j.$map([[..], ..]) returns one result per argument array', function() {
+			assert.deepStrictEqual(p.import('01_basic').basic_call_j.$map([[1.5], [1.5, 3.5], [0.5, 1.5, 'a']]),
+				[[1.5, 2.5, [], []], [1.5, 3.5, [], []], [0.5, 1.5, ['a'], []]])
+		})
+
+		it('01_basic#basic_call_j.$map([]) returns an empty array', function() {
+			assert.deepStrictEqual(p.import('01_basic').basic_call_j.$map([]), [])
+		})
+
+		it('01_basic#basic_call_j.$map(..) keeps going past failed calls', function() {
+			let res = p.import('01_basic').basic_call_j.$map([[1.5], [], [2.5]])
+			assert.deepStrictEqual(res[0], [1.5, 2.5, [], []])
+			assert.instanceOf(res[1], p.exceptions().PythonException)
+			assert.equal(res[1].py_name, 'TypeError')
+			assert.deepStrictEqual(res[2], [2.5, 2.5, [], []])
+		})
+
+		it('01_basic#basic_call_j.$map([1.5]) requires argument arrays', function() {
+			assert.throws(() => p.import('01_basic').basic_call_j.$map([1.5]), Error)
+		})
+
+		it('01_basic#basic_counter_j().add.$map(..) calls the bound method', function() {
+			let counter = p.import('01_basic').basic_counter_j()
+			assert.deepStrictEqual(counter.add.$map([[1.0], [2.0, 2.0]]), [1.0, 5.0])
+		})
+	})
+
+	describe('[js->py] method calls', function() {
+		it('01_basic#basic_counter_j().add(..) updates the instance', function() {
+			let counter = p.import('01_basic').basic_counter_j()
+			counter.add(1.5)
+			assert.equal(counter.add(2.0, 0.5), 2.5)
+			assert.equal(counter.total, 2.5)
+		})
+
+		it('01_basic#basic_counter_j().add is reused and keeps its bound-method attributes', function() {
+			let counter = p.import('01_basic').basic_counter_j()
+			let add = counter.add
+			assert.equal(counter.add, add)
+			assert.equal(add.__name__, 'add')
+			assert.equal(add.$apply([1.5], { b: 2.0 }), 3.0)
+			assert.equal(add.$newMode({getReference: true})(1.0).$isCallable(), false)
+		})
+
+		it('01_basic#basic_counter_j().add follows rebinding on the Python side', function() {
+			let counter = p.import('01_basic').basic_counter_j()
+			assert.equal(counter.add(1.0), 1.0)
+			counter.rebind('add', 5)
+			assert.equal(counter.add, 5)
+			counter.rebind_to('add', 'scale')
+			assert.equal(counter.add(2.0), 4.0)
+		})
+
+		it('01_basic#basic_counter_j().scale(..) calls static methods', function() {
+			assert.equal(p.import('01_basic').basic_counter_j().scale(1.5), 3.0)
+		})
+
+		it('01_basic#basic_counter_j().apply(..) passes methods back to Python', function() {
+			let counter = p.import('01_basic').basic_counter_j()
+			counter.add(2.0)
+			assert.equal(counter.apply(counter.add), 4.0)
+		})
+
+		it('01_basic#basic_counter_j().add after reassignment calls the new attribute', function() {
+			let counter = p.import('01_basic').basic_counter_j()
+			counter.add(1.0)
+			counter.add = p.import('01_basic').basic_float_j
+			assert.equal(counter.add(12830.8877), true)
+		})
+	})
 
 	describe('[js->py->js] echo testing', function() {
 		it('01_basic#basic_echo_tester(null)', function() {
@@ -384,6 +623,13 @@ describe('pyjs: basic functions', function() {
 			assert.strictEqual(big, p.import('01_basic').basic_echo_tester(big))
 		})
 
+		it('01_basic#basic_echo_tester(bigint) at word boundaries', function() {
+			let echo = p.import('01_basic').basic_echo_tester
+			for (let n of [0n, -1n, 2n**63n - 1n, 2n**63n, -(2n**63n), -(2n**63n) - 1n,
+				2n**64n, -(2n**64n), 2n**1000n + 7n, -(2n**1000n) - 7n])
+				assert.strictEqual(echo(n), n)
+		})
+
 		it('01_basic#basic_echo_tester(1.234)', function() {
 			assert.strictEqual(1.234, p.import('01_basic').basic_echo_tester(1.234))
 		})
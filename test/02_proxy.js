@@ -100,6 +100,36 @@ let t = describe('pyjs: proxy functions', function() {
 			assert.isFalse(p.$coerceAs.int(1)
 				.$getMode().getReferenceOnIterate)
 		})
+
+		it('proxy#$getMode(safeIntegerAsNumber) returns false', function() {
+			assert.isFalse(p.$coerceAs.int(1)
+				.$getMode().safeIntegerAsNumber)
+		})
+
+		it('proxy#$getMode(zeroCopyBytes) returns false', function() {
+			assert.isFalse(p.$coerceAs.int(1)
+				.$getMode().zeroCopyBytes)
+		})
+
+		it('proxy#$getMode(typedArrays) returns false', function() {
+			assert.isFalse(p.$coerceAs.int(1)
+				.$getMode().typedArrays)
+		})
+
+		it('proxy#$getMode(numericArrays) returns false', function() {
+			assert.isFalse(p.$coerceAs.int(1)
+				.$getMode().numericArrays)
+		})
+
+		it('proxy#$getMode(dictAsObject) returns false', function() {
+			assert.isFalse(p.$coerceAs.int(1)
+				.$getMode().dictAsObject)
+		})
+
+		it('proxy#$getMode(recordsAsColumns) returns false', function() {
+			assert.isFalse(p.$coerceAs.int(1)
+				.$getMode().recordsAsColumns)
+		})
 	})
 
 	describe('[proxy] mode setting', function() {
@@ -123,6 +153,36 @@ let t = describe('pyjs: proxy functions', function() {
 			assert.isTrue(c.$getMode().getReferenceOnIterate)
 		})
 
+		it('proxy#$mode(safeIntegerAsNumber->true)', function() {
+			let c = p.$coerceAs.int(1).$mode({safeIntegerAsNumber: true})
+			assert.isTrue(c.$getMode().safeIntegerAsNumber)
+		})
+
+		it('proxy#$mode(zeroCopyBytes->true)', function() {
+			let c = p.$coerceAs.int(1).$mode({zeroCopyBytes: true})
+			assert.isTrue(c.$getMode().zeroCopyBytes)
+		})
+
+		it('proxy#$mode(typedArrays->true)', function() {
+			let c = p.$coerceAs.int(1).$mode({typedArrays: true})
+			assert.isTrue(c.$getMode().typedArrays)
+		})
+
+		it('proxy#$mode(numericArrays->true)', function() {
+			let c = p.$coerceAs.int(1).$mode({numericArrays: true})
+			assert.isTrue(c.$getMode().numericArrays)
+		})
+
+		it('proxy#$mode(dictAsObject->true)', function() {
+			let c = p.$coerceAs.int(1).$mode({dictAsObject: true})
+			assert.isTrue(c.$getMode().dictAsObject)
+		})
+
+		it('proxy#$mode(recordsAsColumns->true)', function() {
+			let c = p.$coerceAs.int(1).$mode({recordsAsColumns: true})
+			assert.isTrue(c.$getMode().recordsAsColumns)
+		})
+
 		it('proxy#$mode({}) returns proxy', function() {
 			let proxy = p.$coerceAs.int(1)
 			assert.isTrue(proxy === proxy.$mode())
@@ -138,4 +198,85 @@ let t = describe('pyjs: proxy functions', function() {
 			assert.isTrue(proxy.$getMode().getReference !== proxy.$newMode({getReference: true}).$getMode().getReference)
 		})
 	})
-})
\ No newline at end of file
+
+	describe('[proxy] safeIntegerAsNumber marshalling', function() {
+		it('01_basic#basic_int() returns 1789 (number)', function() {
+			let fn = p.import('01_basic').basic_int.$newMode({safeIntegerAsNumber: true})
+			assert.strictEqual(fn(), 1789)
+		})
+
+		it('01_basic#basic_int_large() falls back to bigint outside of +/-(2^53 - 1)', function() {
+			let fn = p.import('01_basic').basic_int_large.$newMode({safeIntegerAsNumber: true})
+			assert.deepStrictEqual(fn(), [2n**200n, -(2n**200n) - 1n, -(2n**63n), 2n**64n - 1n])
+		})
+
+		it('01_basic#basic_echo_tester() honours the safe integer boundary', function() {
+			let echo = p.import('01_basic').basic_echo_tester.$newMode({safeIntegerAsNumber: true})
+			let max = BigInt(Number.MAX_SAFE_INTEGER)
+			assert.deepStrictEqual(echo([max, -max, max + 1n, -max - 1n, 0n]),
+				[Number.MAX_SAFE_INTEGER, -Number.MAX_SAFE_INTEGER, max + 1n, -max - 1n, 0])
+		})
+	})
+
+	describe('[proxy] dictAsObject marshalling', function() {
+		it('01_basic#basic_echo_tester() returns string-keyed dicts as plain objects', function() {
+			let echo = p.import('01_basic').basic_echo_tester.$newMode({dictAsObject: true})
+			let res = echo({ b: 1.5, a: 'x', c: { d: null } })
+			assert.strictEqual(Object.getPrototypeOf(res), Object.prototype)
+			assert.deepStrictEqual(res, { a: 'x', b: 1.5, c: { d: null } })
+		})
+
+		it('01_basic#basic_echo_tester() keeps dict insertion order', function() {
+			let echo = p.import('01_basic').basic_echo_tester.$newMode({dictAsObject: true})
+			let res = echo([{ y: 1.5, x: 2.5 }, { x: 3.5, y: 4.5 }])
+			assert.deepStrictEqual(Object.keys(res[0]), ['y', 'x'])
+			assert.deepStrictEqual(Object.keys(res[1]), ['x', 'y'])
+		})
+
+		it('01_basic#basic_echo_tester() keeps self references', function() {
+			let echo = p.import('01_basic').basic_echo_tester.$newMode({dictAsObject: true})
+			let obj = { a: 1.5 }
+			obj.self = obj
+			let res = echo(obj)
+			assert.strictEqual(res.self, res)
+		})
+
+		it('01_basic#basic_dict() with non-string keys stays a Map', function() {
+			let fn = p.import('01_basic').basic_dict.$newMode({dictAsObject: true})
+			assert.instanceOf(fn(), Map)
+		})
+
+		it('01_basic#basic_dict() is a Map by default', function() {
+			assert.instanceOf(p.import('01_basic').basic_dict(), Map)
+		})
+	})
+
+	describe('[proxy] recordsAsColumns marshalling', function() {
+		const columns = () => p.import('01_basic').basic_echo_tester
+			.$newMode({recordsAsColumns: true, dictAsObject: true})
+
+		it('01_basic#basic_echo_tester() receives records as a dict of columns', function() {
+			let res = columns()([{ a: 1.5, b: 'x' }, { a: 2.5, b: 'y' }, { a: null, b: 'z' }])
+			assert.deepStrictEqual(res, { a: [1.5, 2.5, null], b: ['x', 'y', 'z'] })
+		})
+
+		it('01_basic#basic_echo_tester() falls back to rows for mismatched keys', function() {
+			let rows = [{ a: 1.5, b: 'x' }, { b: 'y', a: 2.5 }]
+			assert.deepStrictEqual(columns()(rows), rows)
+			assert.deepStrictEqual(columns()([{ a: 1.5 }, 2.5]), [{ a: 1.5 }, 2.5])
+		})
+
+		it('01_basic#basic_echo_tester() leaves rows alone by default', function() {
+			let rows = [{ a: 1.5 }, { a: 2.5 }]
+			let echo = p.import('01_basic').basic_echo_tester.$newMode({dictAsObject: true})
+			assert.deepStrictEqual(echo(rows), rows)
+		})
+
+		it('$coerceAs.Columns() converts a single argument', function() {
+			let echo = p.import('01_basic').basic_echo_tester.$newMode({dictAsObject: true})
+			let res = echo(p.$coerceAs.Columns([{ a: 1.5 }, { a: 2.5 }]))
+			assert.deepStrictEqual(res, { a: [1.5, 2.5] })
+			assert.throws(() => p.$coerceAs.Columns({ a: 1.5 }))
+		})
+	})
+})
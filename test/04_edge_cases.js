@@ -144,4 +144,108 @@ let t = describe('pyjs: edge cases', function() {
 			assert.deepStrictEqual(o, echo)
 		})
 	})
-})
\ No newline at end of file
+
+	describe('[py->js] sequences with objects', function() {
+		it('04_edge#edge_mixed_objects() wraps only object elements', function() {
+			let res = p.import('04_edge').edge_mixed_objects()
+			assert.strictEqual(res[0], 1n)
+			assert.strictEqual(res[2], 'a')
+			assert.strictEqual(typeof res[1], 'function')
+			assert.strictEqual(typeof res[3], 'function')
+			assert.strictEqual(res[4][0], 2.5)
+			assert.strictEqual(typeof res[4][1], 'function')
+			assert.strictEqual(typeof [...res[5]][0], 'function')
+		})
+	})
+
+	describe('[py->js] native Map/Set construction', function() {
+		it('04_edge#edge_dict_objects() wraps object keys and values', function() {
+			let res = p.import('04_edge').edge_dict_objects()
+			assert.instanceOf(res, Map)
+			assert.strictEqual(typeof res.get('o'), 'function')
+			assert.strictEqual(res.get('n'), null)
+			let keys = [...res.keys()]
+			assert.strictEqual(keys.length, 4)
+			assert.strictEqual(typeof keys[1], 'function')
+			assert.strictEqual(res.get(keys[1]), 1n)
+		})
+		it('04_edge#edge_dict_objects() keeps self references', function() {
+			let res = p.import('04_edge').edge_dict_objects()
+			assert.strictEqual(res.get('self'), res)
+		})
+		it('04_edge#edge_frozenset() returns a Set', function() {
+			let res = p.import('04_edge').edge_frozenset()
+			assert.instanceOf(res, Set)
+			assert.isTrue(res.has(1n) && res.has('a') && res.has(2.5))
+		})
+	})
+
+	describe('[js->py] shared references', function() {
+		it('04_edge#edge_shared_identity() preserves shared subtrees and cycles', function() {
+			let edge = p.import('04_edge')
+			let obj = { a: 1n }
+			obj.self = obj
+			let other = { a: 1n }
+			other.self = other
+			assert.isTrue(edge.edge_shared_identity([obj, obj, other]))
+		})
+
+		it('04_edge#edge_shared_identity() can convert the same objects again', function() {
+			let edge = p.import('04_edge')
+			let obj = Object.freeze({ a: 1n, self: null })
+			let arr = [obj, obj, { self: {} }]
+			arr[2].self = arr[2]
+			assert.isFalse(edge.edge_shared_identity(arr))
+			assert.isFalse(edge.edge_shared_identity(arr))
+		})
+	})
+
+	describe('[js->py] native unmarshalling', function() {
+		it('04_edge#edge_same() resolves proxies to the same Python object', function() {
+			let edge = p.import('04_edge')
+			let arr = edge.edge_mixed_objects()
+			assert.isTrue(edge.edge_same(arr[1], arr[4][1]))
+			assert.isTrue(edge.edge_same(arr[1], arr[1].$newMode({ getReference: true })))
+			assert.isFalse(edge.edge_same(arr[1], arr[3]))
+		})
+
+		it('04_edge#edge_same(obj, obj) shares one conversion across arguments', function() {
+			let edge = p.import('04_edge')
+			let obj = { a: [1.5] }
+			assert.isTrue(edge.edge_same(obj, obj))
+			assert.isTrue(edge.edge_same.$apply({ a: obj.a, b: obj.a }))
+			assert.isFalse(edge.edge_same({ a: 1.5 }, { a: 1.5 }))
+		})
+
+		it('04_edge#edge_same.$apply() leaves keyword objects untouched', function() {
+			let edge = p.import('04_edge')
+			let kwargs = { a: 1.5, b: 1.5 }
+			edge.edge_same.$apply(kwargs)
+			assert.deepStrictEqual(kwargs, { a: 1.5, b: 1.5 })
+		})
+
+		it('04_edge#edge_echo() never probes foreign proxies for symbols', function() {
+			let edge = p.import('04_edge')
+			let symbols = 0
+			let obj = new Proxy({ a: 1.5 }, {
+				get: (t, k) => {
+					if (typeof k === 'symbol') symbols++
+					return t[k]
+				}
+			})
+			assert.deepEqual(edge.edge_echo([obj, 2.5, 'b']), [new Map([['a', 1.5]]), 2.5, 'b'])
+			assert.strictEqual(symbols, 0)
+		})
+
+		it('04_edge#edge_echo() with a nested Symbol throws and releases the partial conversion', function() {
+			let edge = p.import('04_edge')
+			let shared = [1.5]
+			for (let i = 0; i < 16; i++) {
+				assert.throws(() => edge.edge_echo([shared, Symbol()]), Error)
+				assert.throws(() => edge.edge_echo({ a: [shared, { b: Symbol() }] }), Error)
+				assert.throws(() => edge.edge_echo.$apply([1.5], { k: [Symbol()] }), Error)
+			}
+			assert.deepEqual(edge.edge_echo([shared, 2.5]), [[1.5], 2.5])
+		})
+	})
+})
@@ -0,0 +1,252 @@
+//////////////////////////////////////////////////////////////////////////
+//	py.js - Node.js/Python Bridge; Node.js-hosted Python.
+//	Copyright (C) 2019  Michael Brown
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as
+//	published by the Free Software Foundation, either version 3 of the
+//	License, or (at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//	Additional permission under the GNU Affero GPL version 3 section 7:
+//
+//	If you modify this Program, or any covered work, by linking or
+//	combining it with other code, such other code is not for that reason
+//	alone subject to any of the requirements of the GNU Affero GPL
+//	version 3.
+//////////////////////////////////////////////////////////////////////////
+
+'use strict'
+
+const p = require('..')
+const assert = require('chai').assert
+const v8 = require('v8')
+const vm = require('vm')
+
+v8.setFlagsFromString('--expose-gc')
+const gc = vm.runInNewContext('gc')
+
+const collect = async () => {
+	for (let i = 0; i < 4; i++) {
+		gc()
+		await new Promise(resolve => setImmediate(resolve))
+	}
+}
+
+let t = describe('pyjs: zero-copy buffers', function() {
+	describe('[py->js] zeroCopyBytes marshalling', function() {
+		it('06_buffers#buffers_large_bytes() matches the copied Buffer', function() {
+			let buffers = p.import('06_buffers')
+			let copied = buffers.buffers_large_bytes()
+			let shared = buffers.buffers_large_bytes.$mode({zeroCopyBytes: true})()
+			assert.instanceOf(shared, Buffer)
+			assert.isTrue(copied.equals(shared))
+		})
+		it('06_buffers#buffers_small_bytes() is copied below the size threshold', function() {
+			let buffers = p.import('06_buffers')
+			let before = buffers.buffers_refcount('small_bytes')
+			let small = buffers.buffers_small_bytes.$mode({zeroCopyBytes: true})()
+			assert.strictEqual(small.toString(), 'pyjs')
+			assert.strictEqual(buffers.buffers_refcount('small_bytes'), before)
+		})
+		it('06_buffers#buffers_large_bytearray() shares memory with Python', function() {
+			let buffers = p.import('06_buffers')
+			let shared = buffers.buffers_large_bytearray.$mode({zeroCopyBytes: true})()
+			shared[10] = 42
+			assert.strictEqual(buffers.buffers_bytearray_byte(10), 42)
+			shared[10] = 0
+		})
+		it('06_buffers#buffers_large_bytes() is copied because bytes are immutable', function() {
+			let buffers = p.import('06_buffers')
+			let before = buffers.buffers_refcount('large_bytes')
+			let copy = buffers.buffers_large_bytes.$mode({zeroCopyBytes: true})()
+			assert.strictEqual(buffers.buffers_refcount('large_bytes'), before)
+			copy[255] = 0
+			assert.strictEqual(buffers.buffers_large_bytes()[255], 255)
+		})
+		it('06_buffers#buffers_large_bytearray() is resizable again once the Buffer is released', async function() {
+			this.timeout(5000)
+			let buffers = p.import('06_buffers')
+			await collect()
+			let shared = buffers.buffers_large_bytearray.$mode({zeroCopyBytes: true})()
+			assert.throws(() => buffers.buffers_bytearray_resize(), /BufferError/)
+			shared = null
+			await collect()
+			assert.doesNotThrow(() => buffers.buffers_bytearray_resize())
+		})
+	})
+
+	describe('[js->py] TypedArray views', function() {
+		it('06_buffers#buffers_view_info(Float32Array) exports format f', function() {
+			let buffers = p.import('06_buffers')
+			assert.deepStrictEqual(buffers.buffers_view_info(new Float32Array(6)), ['f', 4n, [6n], 24n])
+		})
+		it('06_buffers#buffers_view_info(Int16Array) exports format h', function() {
+			let buffers = p.import('06_buffers')
+			assert.deepStrictEqual(buffers.buffers_view_info(new Int16Array(3)), ['h', 2n, [3n], 6n])
+		})
+		it('06_buffers#buffers_view_info(BigInt64Array) exports format q', function() {
+			let buffers = p.import('06_buffers')
+			assert.deepStrictEqual(buffers.buffers_view_info(new BigInt64Array(2)), ['q', 8n, [2n], 16n])
+		})
+		it('06_buffers#buffers_view_sum(Float64Array) reads JS memory', function() {
+			let buffers = p.import('06_buffers')
+			assert.strictEqual(buffers.buffers_view_sum(new Float64Array([1.5, 2.5, 3])), 7)
+		})
+		it('06_buffers#buffers_view_set(Int32Array) writes JS memory', function() {
+			let buffers = p.import('06_buffers')
+			let arr = new Int32Array(4)
+			buffers.buffers_view_set(arr, 2, 42)
+			assert.strictEqual(arr[2], 42)
+		})
+		it('06_buffers#buffers_view_set(subarray) respects the byte offset', function() {
+			let buffers = p.import('06_buffers')
+			let arr = new Float64Array(8)
+			buffers.buffers_view_set(arr.subarray(4), 0, 1.25)
+			assert.strictEqual(arr[4], 1.25)
+		})
+		it('06_buffers#buffers_view_echo(Uint16Array) returns the same TypedArray', function() {
+			let buffers = p.import('06_buffers')
+			let arr = new Uint16Array([1, 2, 3])
+			assert.strictEqual(buffers.buffers_view_echo(arr), arr)
+		})
+		it('06_buffers#buffers_is_bytes(Buffer) keeps Buffers as bytes', function() {
+			let buffers = p.import('06_buffers')
+			assert.isTrue(buffers.buffers_is_bytes(Buffer.from('abc')))
+		})
+		it('06_buffers#buffers_view_info($coerceAs.View(Buffer)) exports format B', function() {
+			let buffers = p.import('06_buffers')
+			let view = p.$coerceAs.View(Buffer.from('abcd'))
+			assert.deepStrictEqual(buffers.buffers_view_info(view), ['B', 1n, [4n], 4n])
+		})
+		it('$coerceAs.View(array) throws', function() {
+			assert.throws(() => p.$coerceAs.View([1, 2]), /TypedArray/)
+		})
+		it('06_buffers#buffers_hold(TypedArray) pins the TypedArray across GC', async function() {
+			this.timeout(5000)
+			let buffers = p.import('06_buffers')
+			buffers.buffers_hold(new Float64Array([1.25, 2.25]))
+			await collect()
+			assert.strictEqual(buffers.buffers_held_sum(), 3.5)
+		})
+	})
+
+	describe('[py<->js] typedArrays marshalling', function() {
+		it('06_buffers#buffers_array(d) returns a Float64Array', function() {
+			let fn = p.import('06_buffers').buffers_array.$newMode({typedArrays: true})
+			let res = fn('d', [1.5, 2.5])
+			assert.instanceOf(res, Float64Array)
+			assert.deepStrictEqual(Array.from(res), [1.5, 2.5])
+		})
+		it('06_buffers#buffers_array(i) returns an Int32Array', function() {
+			let fn = p.import('06_buffers').buffers_array.$newMode({typedArrays: true})
+			assert.instanceOf(fn('i', [1n, -2n]), Int32Array)
+		})
+		it('06_buffers#buffers_array(q) returns a BigInt64Array', function() {
+			let fn = p.import('06_buffers').buffers_array.$newMode({typedArrays: true})
+			assert.deepStrictEqual(Array.from(fn('q', [1n, -2n])), [1n, -2n])
+		})
+		it('06_buffers#buffers_array(d) is a proxy by default', function() {
+			let res = p.import('06_buffers').buffers_array('d', [1.5])
+			assert.notInstanceOf(res, Float64Array)
+		})
+		it('06_buffers#buffers_shared_doubles() shares memory with Python', function() {
+			let buffers = p.import('06_buffers')
+			let res = buffers.buffers_shared_doubles.$newMode({typedArrays: true})()
+			res[1] = 8
+			assert.strictEqual(buffers.buffers_shared_double(1), 8)
+		})
+		it('06_buffers#buffers_readonly_view() is copied into a Uint16Array', function() {
+			let fn = p.import('06_buffers').buffers_readonly_view.$newMode({typedArrays: true})
+			let res = fn()
+			assert.instanceOf(res, Uint16Array)
+			assert.strictEqual(res.length, 2)
+		})
+		it('06_buffers#buffers_matrix_view() keeps its shape as a proxy', function() {
+			let fn = p.import('06_buffers').buffers_matrix_view.$newMode({typedArrays: true})
+			let res = fn()
+			assert.notInstanceOf(res, Uint8Array)
+			assert.deepStrictEqual(res.shape, [2n, 4n])
+		})
+		describe('numpy', function() {
+			before(function() {
+				if (!p.import('06_buffers').buffers_has_numpy())
+					this.skip()
+			})
+			it('06_buffers#buffers_numpy_arange(float32) returns a Float32Array', function() {
+				let fn = p.import('06_buffers').buffers_numpy_arange.$newMode({typedArrays: true})
+				let res = fn(4, 'float32')
+				assert.instanceOf(res, Float32Array)
+				assert.deepStrictEqual(Array.from(res), [0, 1, 2, 3])
+			})
+			it('06_buffers#buffers_numpy_arange(int64) returns a BigInt64Array', function() {
+				let fn = p.import('06_buffers').buffers_numpy_arange.$newMode({typedArrays: true})
+				assert.instanceOf(fn(4, 'int64'), BigInt64Array)
+			})
+			it('06_buffers#buffers_numpy_strided() falls back to a proxy', function() {
+				let fn = p.import('06_buffers').buffers_numpy_strided.$newMode({typedArrays: true})
+				assert.notInstanceOf(fn(8), Float64Array)
+			})
+			it('$coerceAs.NDArray(Float64Array) aliases JS memory', function() {
+				let arr = new Float64Array([1, 2, 3])
+				let res = p.import('06_buffers').buffers_numpy_scale(p.$coerceAs.NDArray(arr), 2)
+				assert.deepStrictEqual(res, ['float64', false])
+				assert.deepStrictEqual(Array.from(arr), [2, 4, 6])
+			})
+			it('$coerceAs.StructuredArray(records) builds a record array', function() {
+				let rec = p.$coerceAs.StructuredArray([{ a: 1.5, b: 'x' }, { a: 2.5, b: 'y' }])
+				assert.deepStrictEqual(p.import('06_buffers').buffers_recarray_info(rec),
+					[['a', 'b'], 2n, [1.5, 2.5]])
+			})
+		})
+	})
+
+	describe('[py->js] numericArrays marshalling', function() {
+		let mode = {numericArrays: true}
+		it('06_buffers#buffers_float_list() returns a Float64Array', function() {
+			let res = p.import('06_buffers').buffers_float_list.$newMode(mode)()
+			assert.instanceOf(res, Float64Array)
+			assert.deepStrictEqual(Array.from(res), [0.25, -1.5, 3])
+		})
+		it('06_buffers#buffers_int_list() returns an Int32Array', function() {
+			let res = p.import('06_buffers').buffers_int_list.$newMode(mode)()
+			assert.instanceOf(res, Int32Array)
+			assert.deepStrictEqual(Array.from(res), [1, -2, 2147483647, -2147483648])
+		})
+		it('06_buffers#buffers_sequence(tuple) returns a Float64Array', function() {
+			let res = p.import('06_buffers').buffers_sequence.$newMode(mode)([1.5, 2.5], true)
+			assert.instanceOf(res, Float64Array)
+		})
+		it('06_buffers#buffers_wide_int_list() stays an Array', function() {
+			let res = p.import('06_buffers').buffers_wide_int_list.$newMode(mode)()
+			assert.deepStrictEqual(res, [1n, 2147483648n])
+		})
+		it('06_buffers#buffers_mixed_list() stays an Array', function() {
+			let res = p.import('06_buffers').buffers_mixed_list.$newMode(mode)()
+			assert.deepStrictEqual(res, [1n, 2.5])
+		})
+		it('06_buffers#buffers_bool_list() stays an Array', function() {
+			let res = p.import('06_buffers').buffers_bool_list.$newMode(mode)()
+			assert.deepStrictEqual(res, [true, false])
+		})
+		it('06_buffers#buffers_sequence([]) stays an Array', function() {
+			let res = p.import('06_buffers').buffers_sequence.$newMode(mode)([], false)
+			assert.deepStrictEqual(res, [])
+		})
+		it('06_buffers#buffers_nested_same() keeps shared references', function() {
+			let res = p.import('06_buffers').buffers_nested_same.$newMode(mode)()
+			assert.instanceOf(res[0], Float64Array)
+			assert.strictEqual(res[0], res[1])
+		})
+		it('06_buffers#buffers_float_list() is an Array by default', function() {
+			assert.isArray(p.import('06_buffers').buffers_float_list())
+		})
+	})
+})
@@ -0,0 +1,94 @@
+//////////////////////////////////////////////////////////////////////////
+//	py.js - Node.js/Python Bridge; Node.js-hosted Python.
+//	Copyright (C) 2019  Michael Brown
+//
+//	This program is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Affero General Public License as
+//	published by the Free Software Foundation, either version 3 of the
+//	License, or (at your option) any later version.
+//
+//	This program is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Affero General Public License for more details.
+//
+//	You should have received a copy of the GNU Affero General Public License
+//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+//	Additional permission under the GNU Affero GPL version 3 section 7:
+//
+//	If you modify this Program, or any covered work, by linking or
+//	combining it with other code, such other code is not for that reason
+//	alone subject to any of the requirements of the GNU Affero GPL
+//	version 3.
+//////////////////////////////////////////////////////////////////////////
+
+'use strict'
+
+const p = require('..')
+const assert = require('chai').assert
+
+let t = describe('pyjs: expression plans', function() {
+	describe('[js->py->js] plan evaluation', function() {
+		it('07_plan chains attribute access and calls', function() {
+			let m = p.plan('mod')`mod.plan_matrix([[1, 2], [3, 4]]).row(1).scale(2, offset=0.5).total()`
+			assert.strictEqual(m(p.import('07_plan')), 15)
+		})
+
+		it('07_plan builds lists and tuples from their items', function() {
+			let types = p.plan('mod', 'x')`mod.plan_types([x, 1], (x,), (), (x), [])`
+			assert.deepStrictEqual(types(p.import('07_plan'), 'a'), ['list', 'tuple', 'tuple', 'str', 'list'])
+			let total = p.plan('mod', 'x')`mod.plan_matrix([[x, 2], [3, x]]).total()`
+			assert.strictEqual(total(p.import('07_plan'), 1.5), 8)
+		})
+
+		it('07_plan indexes with literals and keywords', function() {
+			let lookup = p.plan('mod')`mod.plan_lookup['b\'c']['d']`
+			assert.strictEqual(lookup(p.import('07_plan')), 'e')
+			let last = p.plan('mod', 'i')`mod.plan_lookup['a'][i]`
+			assert.strictEqual(last(p.import('07_plan'), -1n), 3n)
+		})
+
+		it('07_plan is reusable with different inputs', function() {
+			let scale = p.plan('m', 'by')`m.scale(by).total()`
+			let matrix = p.import('07_plan').plan_matrix([[1.5, 2.5]])
+			assert.strictEqual(scale(matrix, 2), 8)
+			assert.strictEqual(scale(matrix, -1), -4)
+		})
+
+		it('07_plan embeds interpolated values', function() {
+			let mod = p.import('07_plan')
+			let m = p.plan`${mod}.plan_matrix(${[[1, 2]]}).scale(${3}).total()`
+			assert.strictEqual(m(), 9)
+		})
+
+		it('07_plan $newMode marshals the result with the given modes', function() {
+			let rows = p.plan('mod')`mod.plan_matrix([[1, 2]]).rows`
+				.$newMode({ getReference: true })(p.import('07_plan'))
+			assert.strictEqual(rows.__len__(), 1n)
+		})
+	})
+
+	describe('[js->py->js] plan errors', function() {
+		it('07_plan raises Python exceptions', function() {
+			let fail = p.plan('mod')`mod.plan_fail('plan')`
+			assert.throws(() => fail(p.import('07_plan')), p.exceptions().PythonException)
+		})
+
+		it('07_plan throws on arguments that cannot be converted', function() {
+			let echo = p.plan('mod', 'x')`mod.plan_matrix(x).rows`
+			let mod = p.import('07_plan')
+			for (let i = 0; i < 16; i++)
+				assert.throws(() => echo(mod, [[1.5], [Symbol()]]), Error)
+			assert.deepStrictEqual(echo(mod, [[1.5]]), [[1.5]])
+		})
+
+		it('07_plan rejects malformed expressions', function() {
+			assert.throws(() => p.plan('a')`a.`, Error)
+			assert.throws(() => p.plan('a')`b.c`, Error)
+			assert.throws(() => p.plan('a')`a(k=1, 2)`, Error)
+			assert.throws(() => p.plan('a')`a([1 2])`, Error)
+			assert.throws(() => p.plan('a')`a((1, 2)`, Error)
+		})
+	})
+})
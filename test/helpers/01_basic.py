@@ -23,6 +23,8 @@
 #//	version 3.
 #//////////////////////////////////////////////////////////////////////////
 
+from datetime import datetime, timedelta, timezone
+
 # Py->JS Tests
 
 def basic_none():
@@ -34,6 +36,9 @@ def basic_bool():
 def basic_int():
 	return 1789
 
+def basic_int_large():
+	return (2**200, -(2**200) - 1, -(2**63), 2**64 - 1)
+
 def basic_float():
 	return 10234678.5
 
@@ -46,6 +51,9 @@ def basic_byte_array():
 def basic_string():
 	return 'this is a string'
 
+def basic_string_kinds():
+	return ['caf\u00e9 \u00ff', '\u3042\u3044\u3046', 'emoji \U0001F600!', 'nul\x00inside', '']
+
 def basic_tuple():
 	return (1,2,3,4)
 
@@ -58,6 +66,15 @@ def basic_dict():
 def basic_set():
 	return set([1,2,3,4,'c',10.1])
 
+def basic_datetime():
+	return datetime(2019, 1, 4, 12, 55, 11, 14000)
+
+def basic_datetime_aware():
+	return datetime(2019, 1, 4, 12, 55, 11, 14000, tzinfo=timezone(timedelta(hours=9)))
+
+def basic_records():
+	return [{'stats_alpha': i, 'stats_beta': 'v'} for i in range(3)]
+
 def basic_function():
 	def bfun():
 		return 1.1*2
@@ -103,12 +120,18 @@ def basic_bool_j(a,b):
 def basic_int_j(a):
 	return a == 98359834579
 
+def basic_int_large_j(a, b):
+	return a == 2**521 - 1 and b == -(2**64) - 1
+
 def basic_float_j(a):
 	return a == 12830.8877
 
 def basic_string_j(a):
 	return 'あいうえお' == a
 
+def basic_string_kinds_j(a):
+	return basic_string_kinds() + ['\ud800x'] == a
+
 def basic_tuple_j(a):
 	return (1.1,"a",99.9,True,1) == a
 
@@ -122,7 +145,37 @@ def basic_dict_j(a):
 	return {'a': 1.3, 'b': 100.1, 'あいうえお': { '7':True } } == a
 
 def basic_datetime_j(a):
-	return a.hour == 12 and a.minute == 55 and a.second == 11 and a.month == 1 and a.year == 2019 and a.day == 4
+	return type(a) is datetime and a.microsecond == 14000 and a.hour == 12 and a.minute == 55 and a.second == 11 and a.month == 1 and a.year == 2019 and a.day == 4
+
+def basic_records_j(a):
+	return [r['stats_a'] for r in a] == [1.5, 2.5] and a[0].keys() == a[1].keys()
+
+def basic_call_j(a, b=2.5, *rest, **kw):
+	return [a, b, list(rest), sorted(kw.items())]
+
+class basic_counter_j:
+	def __init__(self):
+		self.total = 0
+
+	def add(self, a, b=1.0):
+		self.total += a * b
+		return self.total
+
+	def apply(self, fn):
+		return fn(self.total)
+
+	def rebind(self, name, value):
+		setattr(self, name, value)
+
+	def rebind_to(self, name, other):
+		setattr(self, name, getattr(self, other))
+
+	@staticmethod
+	def scale(a):
+		return a * 2
+
+def basic_datetime_utc_j(a):
+	return a == datetime(2019, 1, 4, 3, 55, 11, 14000, tzinfo=timezone.utc).astimezone().replace(tzinfo=None)
 
 #//////////////////////////////////////////////////////////////////////////
 
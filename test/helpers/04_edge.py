@@ -28,3 +28,25 @@ def edge_dict_tuple():
 
 def edge_echo(x):
 	return x
+
+class EdgeObject:
+	pass
+
+def edge_mixed_objects():
+	o = EdgeObject()
+	return [1, o, 'a', EdgeObject(), (2.5, o), {o}]
+
+def edge_dict_objects():
+	o = EdgeObject()
+	d = {'o': o, o: 1, 'n': None}
+	d['self'] = d
+	return d
+
+def edge_frozenset():
+	return frozenset([1, 'a', 2.5])
+
+def edge_shared_identity(a):
+	return a[0] is a[1] and a[0]['self'] is a[0] and a[2] is not a[0]
+
+def edge_same(a, b):
+	return a is b
@@ -0,0 +1,136 @@
+#//////////////////////////////////////////////////////////////////////////
+#//	py.js - Node.js/Python Bridge; Node.js-hosted Python.
+#//	Copyright (C) 2019  Michael Brown
+#//
+#//	This program is free software: you can redistribute it and/or modify
+#//	it under the terms of the GNU Affero General Public License as
+#//	published by the Free Software Foundation, either version 3 of the
+#//	License, or (at your option) any later version.
+#//
+#//	This program is distributed in the hope that it will be useful,
+#//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+#//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#//	GNU Affero General Public License for more details.
+#//
+#//	You should have received a copy of the GNU Affero General Public License
+#//	along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#//
+#//	Additional permission under the GNU Affero GPL version 3 section 7:
+#//
+#//	If you modify this Program, or any covered work, by linking or
+#//	combining it with other code, such other code is not for that reason
+#//	alone subject to any of the requirements of the GNU Affero GPL
+#//	version 3.
+#//////////////////////////////////////////////////////////////////////////
+
+import sys
+
+large_bytes = bytes(range(256)) * 64
+large_bytearray = bytearray(4096)
+small_bytes = b'pyjs'
+
+def buffers_large_bytes():
+	return large_bytes
+
+def buffers_large_bytearray():
+	return large_bytearray
+
+def buffers_small_bytes():
+	return small_bytes
+
+def buffers_refcount(name):
+	return sys.getrefcount(globals()[name])
+
+def buffers_bytearray_byte(i):
+	return large_bytearray[i]
+
+def buffers_bytearray_resize():
+	large_bytearray.append(0)
+	large_bytearray.pop()
+
+def buffers_view_info(v):
+	m = memoryview(v)
+	return [m.format, m.itemsize, list(m.shape), m.nbytes]
+
+def buffers_view_sum(v):
+	return sum(memoryview(v))
+
+def buffers_view_set(v, i, value):
+	memoryview(v)[i] = value
+
+def buffers_view_echo(v):
+	return v
+
+def buffers_is_bytes(v):
+	return isinstance(v, bytes)
+
+held_views = []
+
+def buffers_hold(v):
+	held_views.append(v)
+
+def buffers_held_sum():
+	return sum(sum(memoryview(v)) for v in held_views)
+
+import array
+
+shared_doubles = array.array('d', [0.5, 1.5, 2.5])
+
+def buffers_array(typecode, values):
+	return array.array(typecode, values)
+
+def buffers_shared_doubles():
+	return shared_doubles
+
+def buffers_shared_double(i):
+	return shared_doubles[i]
+
+def buffers_readonly_view():
+	return memoryview(bytes([1, 2, 3, 4])).cast('H')
+
+def buffers_matrix_view():
+	return memoryview(bytearray(range(8))).cast('B', [2, 4])
+
+def buffers_has_numpy():
+	try:
+		import numpy
+		return True
+	except ImportError:
+		return False
+
+def buffers_numpy_arange(n, dtype):
+	import numpy
+	return numpy.arange(n, dtype=dtype)
+
+def buffers_numpy_strided(n):
+	import numpy
+	return numpy.arange(n, dtype='float64')[::2]
+
+def buffers_numpy_scale(a, factor):
+	a *= factor
+	return [str(a.dtype), a.flags['OWNDATA']]
+
+def buffers_sequence(values, as_tuple):
+	return tuple(values) if as_tuple else list(values)
+
+def buffers_float_list():
+	return [0.25, -1.5, 3.0]
+
+def buffers_int_list():
+	return [1, -2, 2**31 - 1, -2**31]
+
+def buffers_wide_int_list():
+	return [1, 2**31]
+
+def buffers_mixed_list():
+	return [1, 2.5]
+
+def buffers_bool_list():
+	return [True, False]
+
+def buffers_nested_same():
+	l = [1.0, 2.0]
+	return [l, l]
+
+def buffers_recarray_info(rec):
+	return [list(rec.dtype.names), len(rec), rec['a'].tolist()]